@@ -58,11 +58,23 @@ void CrdbDB::Cleanup() {
   delete conn_;
 }
 
+Status CrdbDB::Ping() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  try {
+    pqxx::nontransaction tx(*conn_);
+    tx.exec("SELECT 1");
+    return Status::kOK;
+  } catch (std::exception const &e) {
+    std::cerr << e.what() << endl;
+    return Status::kError;
+  }
+}
+
 /*
   key always in the order {id1, id2, type} or {id1}
   fields always in the other {timestamp, value}
 */
-Status CrdbDB::Read(DataTable table, const std::vector<Field> & key, std::vector<TimestampValue> &result) {
+Status CrdbDB::Read(DataTable table, const Key &key, std::vector<TimestampValue> &result) {
 
   std::lock_guard<std::mutex> lock(mutex_);
 
@@ -81,21 +93,21 @@ Status CrdbDB::Read(DataTable table, const std::vector<Field> & key, std::vector
   }
 }
 
-pqxx::result CrdbDB::DoRead(pqxx::transaction_base &tx, const DataTable table, const std::vector<Field> &key) {
+pqxx::result CrdbDB::DoRead(pqxx::transaction_base &tx, const DataTable table, const Key &key) {
   if (table == DataTable::Objects) {
-    return tx.exec_prepared("read_object", key[0].value);
+    return tx.exec_prepared("read_object", key.id1);
   } else if (table == DataTable::Edges) {
-    return tx.exec_prepared("read_edge", key[0].value, key[1].value, key[2].value);
+    return tx.exec_prepared("read_edge", key.id1, key.id2, key.type);
   } else {
     throw std::invalid_argument("Received unknown table");
   }
 }
 
-Status CrdbDB::Scan(DataTable table, const std::vector<Field> & key, int n, std::vector<TimestampValue> &buffer) {
+Status CrdbDB::Scan(DataTable table, const Key &key, int n, std::vector<TimestampValue> &buffer) {
   return Status::kNotImplemented;
 }
 
-Status CrdbDB::Update(DataTable table, const std::vector<DB::Field> &key, TimestampValue const &value)  {
+Status CrdbDB::Update(DataTable table, const Key &key, TimestampValueRef const &value)  {
   std::lock_guard<std::mutex> lock(mutex_);
   try {
     pqxx::nontransaction tx(*conn_);
@@ -109,17 +121,17 @@ Status CrdbDB::Update(DataTable table, const std::vector<DB::Field> &key, Timest
   }
 }
 
-pqxx::result CrdbDB::DoUpdate(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key, TimestampValue const &value) {
+pqxx::result CrdbDB::DoUpdate(pqxx::transaction_base &tx, DataTable table, const Key &key, TimestampValueRef const &value) {
   if (table == DataTable::Objects) {
-    return tx.exec_prepared("update_object", value.timestamp, value.value, key[0].value);
+    return tx.exec_prepared("update_object", value.timestamp, value.value, key.id1);
   } else if (table == DataTable::Edges) {
-    return tx.exec_prepared("update_edge", value.timestamp, value.value, key[0].value, key[1].value, key[2].value);
+    return tx.exec_prepared("update_edge", value.timestamp, value.value, key.id1, key.id2, key.type);
   } else {
     throw std::invalid_argument("Received unknown table");
   }
 }
 
-Status CrdbDB::Insert(DataTable table, const std::vector<Field> &key, const TimestampValue & value) {
+Status CrdbDB::Insert(DataTable table, const Key &key, const TimestampValueRef & value) {
   std::lock_guard<std::mutex> lock(mutex_);
   try {
     pqxx::nontransaction tx(*conn_);
@@ -133,19 +145,19 @@ Status CrdbDB::Insert(DataTable table, const std::vector<Field> &key, const Time
   }
 }
 
-pqxx::result CrdbDB::DoInsert(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key, const TimestampValue & value) {
+pqxx::result CrdbDB::DoInsert(pqxx::transaction_base &tx, DataTable table, const Key &key, const TimestampValueRef & value) {
   if (table == DataTable::Objects) {
-    return tx.exec_prepared("insert_object", key[0].value, value.timestamp, value.value);
+    return tx.exec_prepared("insert_object", key.id1, value.timestamp, value.value);
   } else if (table == DataTable::Edges) {
-    benchmark::EdgeType type = static_cast<benchmark::EdgeType>(key[2].value);
+    benchmark::EdgeType type = static_cast<benchmark::EdgeType>(key.type);
     if (type == benchmark::EdgeType::Other) {
-      return tx.exec_prepared("insert_edge_other", key[0].value, key[1].value, key[2].value, value.timestamp, value.value);
+      return tx.exec_prepared("insert_edge_other", key.id1, key.id2, key.type, value.timestamp, value.value);
     } else if (type == benchmark::EdgeType::Bidirectional) {
-      return tx.exec_prepared("insert_edge_bidirectional", key[0].value, key[1].value, key[2].value, value.timestamp, value.value);
+      return tx.exec_prepared("insert_edge_bidirectional", key.id1, key.id2, key.type, value.timestamp, value.value);
     } else if (type == benchmark::EdgeType::Unique) {
-      return tx.exec_prepared("insert_edge_unique", key[0].value, key[1].value, key[2].value, value.timestamp, value.value);
+      return tx.exec_prepared("insert_edge_unique", key.id1, key.id2, key.type, value.timestamp, value.value);
     } else if (type == benchmark::EdgeType::UniqueAndBidirectional) {
-      return tx.exec_prepared("insert_edge_bi_unique", key[0].value, key[1].value, key[2].value, value.timestamp, value.value);
+      return tx.exec_prepared("insert_edge_bi_unique", key.id1, key.id2, key.type, value.timestamp, value.value);
     } else {
       throw std::invalid_argument("Received unknown type");
     }
@@ -265,7 +277,7 @@ Status CrdbDB::BatchRead(DataTable table,
 
 }
 
-Status CrdbDB::Delete(DataTable table, const std::vector<Field> &key, const TimestampValue &value) {
+Status CrdbDB::Delete(DataTable table, const Key &key, const TimestampValueRef &value) {
   std::lock_guard<std::mutex> lock(mutex_);
   try {
     pqxx::nontransaction tx(*conn_);
@@ -279,11 +291,11 @@ Status CrdbDB::Delete(DataTable table, const std::vector<Field> &key, const Time
   }
 }
 
-pqxx::result CrdbDB::DoDelete(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key, const TimestampValue &value) {
+pqxx::result CrdbDB::DoDelete(pqxx::transaction_base &tx, DataTable table, const Key &key, const TimestampValueRef &value) {
   if (table == DataTable::Objects) {
-    return tx.exec_prepared("delete_object", key[0].value, value.timestamp);
+    return tx.exec_prepared("delete_object", key.id1, value.timestamp);
   } else if (table == DataTable::Edges) {
-    return tx.exec_prepared("delete_edge", key[0].value, key[1].value, key[2].value, value.timestamp);
+    return tx.exec_prepared("delete_edge", key.id1, key.id2, key.type, value.timestamp);
   } else {
     throw std::invalid_argument("Received unknown table");
   }
@@ -510,9 +522,9 @@ std::string CrdbDB::GenerateMergedReadQuery(const std::vector<DB_Operation> &rea
   for (int i = 0; i < read_operations.size(); i++) {
     const DB_Operation operation = read_operations[i];
     if (operation.table == DataTable::Objects) {
-      query += "SELECT timestamp, value FROM " + object_table_ + " WHERE id = " + std::to_string((operation.key)[0].value);
+      query += "SELECT timestamp, value FROM " + object_table_ + " WHERE id = " + std::to_string(operation.key.id1);
     } else if (operation.table == DataTable::Edges) {
-      query += "SELECT timestamp, value FROM " + edge_table_ + " WHERE id1 = " + std::to_string((operation.key)[0].value) + " AND id2 = " + std::to_string((operation.key)[1].value) + " AND type = " + std::to_string((operation.key)[2].value);
+      query += "SELECT timestamp, value FROM " + edge_table_ + " WHERE id1 = " + std::to_string(operation.key.id1) + " AND id2 = " + std::to_string(operation.key.id2) + " AND type = " + std::to_string(operation.key.type);
     }
     query += ";";
   }
@@ -525,14 +537,14 @@ std::string CrdbDB::GenerateMergedInsertQuery(const std::vector<DB_Operation> &i
   for (int i = 0; i < insert_operations.size(); i++) {
     const DB_Operation operation = insert_operations[i];
     if (operation.table == DataTable::Objects) {
-      query += "INSERT INTO " +object_table_ + " (id, timestamp, value) VALUES (" + std::to_string((operation.key)[0].value) + ", " + std::to_string(operation.time_and_value.timestamp) + ", " + conn_->quote(operation.time_and_value.value) + ")";
+      query += "INSERT INTO " +object_table_ + " (id, timestamp, value) VALUES (" + std::to_string(operation.key.id1) + ", " + std::to_string(operation.time_and_value.timestamp) + ", " + conn_->quote(operation.time_and_value.value) + ")";
     } else if (operation.table == DataTable::Edges) {
-      std::string id1 = std::to_string((operation.key)[0].value);
-      std::string id2 = std::to_string((operation.key)[1].value);
-      std::string type = std::to_string((operation.key)[2].value);
+      std::string id1 = std::to_string(operation.key.id1);
+      std::string id2 = std::to_string(operation.key.id2);
+      std::string type = std::to_string(operation.key.type);
       std::string timestamp = std::to_string(operation.time_and_value.timestamp);
       std::string value = conn_->quote(operation.time_and_value.value);
-      benchmark::EdgeType edge_type = static_cast<benchmark::EdgeType>((operation.key)[2].value);
+      benchmark::EdgeType edge_type = static_cast<benchmark::EdgeType>(operation.key.type);
       query += "INSERT INTO " + edge_table_ + " (id1, id2, type, timestamp, value) SELECT " + id1 + ", " + id2 + ", " + type + ", " + timestamp + ", " + value + " WHERE NOT EXISTS ";
       if (edge_type == benchmark::EdgeType::Other) {
         query +=  "(SELECT 1 FROM " + edge_table_ + " WHERE (id1=" + id1 + " AND type=0) OR (id1=" + id1 + " AND type=2) OR (id1=" + id1 + " AND id2=" + id2 + " AND type=1) OR (id1=" + id2 + " AND id2=" + id1 + "))";
@@ -555,9 +567,9 @@ std::string CrdbDB::GenerateMergedUpdateQuery(const std::vector<DB_Operation> &u
   for (int i = 0; i < update_operations.size(); i++) {
     const DB_Operation operation = update_operations[i];
     if (operation.table == DataTable::Objects) {
-      query += "UPDATE " + object_table_ + " SET timestamp = " + std::to_string(operation.time_and_value.timestamp) + ", value = " + conn_->quote(operation.time_and_value.value) + " WHERE id = " + std::to_string((operation.key)[0].value) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp);
+      query += "UPDATE " + object_table_ + " SET timestamp = " + std::to_string(operation.time_and_value.timestamp) + ", value = " + conn_->quote(operation.time_and_value.value) + " WHERE id = " + std::to_string(operation.key.id1) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp);
     } else if (operation.table == DataTable::Edges) {
-      query += "UPDATE " + edge_table_ + " SET timestamp = " + std::to_string(operation.time_and_value.timestamp) + ", value = " + conn_->quote(operation.time_and_value.value) + " WHERE id1 = " + std::to_string((operation.key)[0].value) + " AND id2 = " + std::to_string((operation.key)[1].value) + " AND type = " + std::to_string((operation.key)[2].value) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp);
+      query += "UPDATE " + edge_table_ + " SET timestamp = " + std::to_string(operation.time_and_value.timestamp) + ", value = " + conn_->quote(operation.time_and_value.value) + " WHERE id1 = " + std::to_string(operation.key.id1) + " AND id2 = " + std::to_string(operation.key.id2) + " AND type = " + std::to_string(operation.key.type) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp);
     }
     query += ";";
   }
@@ -570,9 +582,9 @@ std::string CrdbDB::GenerateMergedDeleteQuery(const std::vector<DB_Operation> &d
   for (int i = 0; i < delete_operations.size(); i++) {
     const DB_Operation operation = delete_operations[i];
     if (operation.table == DataTable::Objects) {
-      query += "DELETE FROM " + object_table_ + " WHERE id = " + std::to_string((operation.key)[0].value) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp);
+      query += "DELETE FROM " + object_table_ + " WHERE id = " + std::to_string(operation.key.id1) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp);
     } else if (operation.table == DataTable::Edges) {
-      query += "DELETE FROM " + edge_table_ + " WHERE id1 = " + std::to_string((operation.key)[0].value) + " AND id2 = " + std::to_string((operation.key)[1].value) + " AND type = " + std::to_string((operation.key)[2].value) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp);
+      query += "DELETE FROM " + edge_table_ + " WHERE id1 = " + std::to_string(operation.key.id1) + " AND id2 = " + std::to_string(operation.key.id2) + " AND type = " + std::to_string(operation.key.type) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp);
     }
     query += ";";
   }
@@ -19,17 +19,19 @@ class CrdbDB : public DB {
 
   void Cleanup();
 
-  Status Read(DataTable table, const std::vector<Field> & key, std::vector<TimestampValue> &buffer);
+  Status Ping();
 
-  Status Scan(DataTable table, const std::vector<Field> & key, int n, std::vector<TimestampValue> &buffer);
+  Status Read(DataTable table, const Key &key, std::vector<TimestampValue> &buffer);
 
-  Status Update(DataTable table, const std::vector<Field> &key, TimestampValue const & value);
+  Status Scan(DataTable table, const Key &key, int n, std::vector<TimestampValue> &buffer);
 
-  Status Insert(DataTable table, const std::vector<Field> &key, TimestampValue const & value);
+  Status Update(DataTable table, const Key &key, TimestampValueRef const & value);
+
+  Status Insert(DataTable table, const Key &key, TimestampValueRef const & value);
   
 
-  Status Delete(DataTable table, const std::vector<Field> &key,
-                        TimestampValue const & value);
+  Status Delete(DataTable table, const Key &key,
+                        TimestampValueRef const & value);
 
   Status Execute(const DB_Operation &operation,
                          std::vector<TimestampValue> &read_buffer, // for reads
@@ -50,16 +52,16 @@ class CrdbDB : public DB {
   std::string object_table_;
   std::string edge_table_;
 
-  pqxx::result DoRead(pqxx::transaction_base &tx, const DataTable table, const std::vector<Field> &key);
+  pqxx::result DoRead(pqxx::transaction_base &tx, const DataTable table, const Key &key);
 
-  // pqxx::result DoScan(pqxx::transaction_base &tx, const std::string &table, const std::vector<Field> &key, int len,
+  // pqxx::result DoScan(pqxx::transaction_base &tx, const std::string &table, const Key &key, int len,
   //                             const std::vector<std::string> *fields, const std::vector<Field> &limit);
 
-  pqxx::result DoUpdate(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key, TimestampValue const &value);
+  pqxx::result DoUpdate(pqxx::transaction_base &tx, DataTable table, const Key &key, TimestampValueRef const &value);
 
-  pqxx::result DoInsert(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key, const TimestampValue & value);
+  pqxx::result DoInsert(pqxx::transaction_base &tx, DataTable table, const Key &key, const TimestampValueRef & value);
 
-  pqxx::result DoDelete(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key, const TimestampValue &value);
+  pqxx::result DoDelete(pqxx::transaction_base &tx, DataTable table, const Key &key, const TimestampValueRef &value);
 
   Status BatchInsertObjects(DataTable table, const std::vector<std::vector<Field>> &keys,
                                   const std::vector<TimestampValue> &values);
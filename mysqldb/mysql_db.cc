@@ -15,7 +15,7 @@ namespace benchmark {
 
 inline std::string ReadObjectSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id = key[0].value;
+  auto id = key.id1;
   std::ostringstream stmt;
   stmt << "SELECT timestamp, value FROM objects WHERE id=" << id;
   return stmt.str();
@@ -23,9 +23,9 @@ inline std::string ReadObjectSQL(const DB::DB_Operation &op) {
 
 inline std::string ReadEdgeSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id1 = key[0].value;
-  auto id2 = key[1].value;
-  auto type = key[2].value;
+  auto id1 = key.id1;
+  auto id2 = key.id2;
+  auto type = key.type;
   std::ostringstream stmt;
   stmt << "SELECT timestamp, value FROM edges WHERE id1=" << id1
        << " AND id2=" << id2 << " AND type=" << type;
@@ -34,7 +34,7 @@ inline std::string ReadEdgeSQL(const DB::DB_Operation &op) {
 
 inline std::string InsertObjectSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id = key[0].value;
+  auto id = key.id1;
   auto timestamp = op.time_and_value.timestamp;
   auto val = op.time_and_value.value;
   std::ostringstream stmt;
@@ -45,9 +45,9 @@ inline std::string InsertObjectSQL(const DB::DB_Operation &op) {
 
 inline std::string InsertOtherSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id1 = key[0].value;
-  auto id2 = key[1].value;
-  auto type = key[2].value;
+  auto id1 = key.id1;
+  auto id2 = key.id2;
+  auto type = key.type;
   auto timestamp = op.time_and_value.timestamp;
   auto val = op.time_and_value.value;
   std::ostringstream stmt;
@@ -62,9 +62,9 @@ inline std::string InsertOtherSQL(const DB::DB_Operation &op) {
 
 inline std::string InsertUniqueSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id1 = key[0].value;
-  auto id2 = key[1].value;
-  auto type = key[2].value;
+  auto id1 = key.id1;
+  auto id2 = key.id2;
+  auto type = key.type;
   auto timestamp = op.time_and_value.timestamp;
   auto val = op.time_and_value.value;
   std::ostringstream stmt;
@@ -77,9 +77,9 @@ inline std::string InsertUniqueSQL(const DB::DB_Operation &op) {
 
 inline std::string InsertBidrectionalSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id1 = key[0].value;
-  auto id2 = key[1].value;
-  auto type = key[2].value;
+  auto id1 = key.id1;
+  auto id2 = key.id2;
+  auto type = key.type;
   auto timestamp = op.time_and_value.timestamp;
   auto val = op.time_and_value.value;
   std::ostringstream stmt;
@@ -95,9 +95,9 @@ inline std::string InsertBidrectionalSQL(const DB::DB_Operation &op) {
 
 inline std::string InsertUniqueAndBidirectionalSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id1 = key[0].value;
-  auto id2 = key[1].value;
-  auto type = key[2].value;
+  auto id1 = key.id1;
+  auto id2 = key.id2;
+  auto type = key.type;
   auto timestamp = op.time_and_value.timestamp;
   auto val = op.time_and_value.value;
   std::ostringstream stmt;
@@ -111,7 +111,7 @@ inline std::string InsertUniqueAndBidirectionalSQL(const DB::DB_Operation &op) {
 
 inline std::string DeleteObjectSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id = key[0].value;
+  auto id = key.id1;
   auto timestamp = op.time_and_value.timestamp;
   std::ostringstream stmt;
   stmt << "DELETE FROM objects where timestamp < " << timestamp
@@ -121,9 +121,9 @@ inline std::string DeleteObjectSQL(const DB::DB_Operation &op) {
 
 inline std::string DeleteEdgeSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id1 = key[0].value;
-  auto id2 = key[1].value;
-  auto type = key[2].value;
+  auto id1 = key.id1;
+  auto id2 = key.id2;
+  auto type = key.type;
   auto timestamp = op.time_and_value.timestamp;
   std::ostringstream stmt;
   stmt << "DELETE FROM edges where timestamp<" << timestamp
@@ -133,7 +133,7 @@ inline std::string DeleteEdgeSQL(const DB::DB_Operation &op) {
 
 inline std::string UpdateObjectSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id = std::to_string(key[0].value);
+  auto id = std::to_string(key.id1);
   auto timestamp = op.time_and_value.timestamp;
   auto val = op.time_and_value.value;
   std::ostringstream stmt;
@@ -144,9 +144,9 @@ inline std::string UpdateObjectSQL(const DB::DB_Operation &op) {
 
 inline std::string UpdateEdgeSQL(const DB::DB_Operation &op) {
   auto &key = op.key;
-  auto id1 = key[0].value;
-  auto id2 = key[1].value;
-  auto type = key[2].value;
+  auto id1 = key.id1;
+  auto id2 = key.id2;
+  auto type = key.type;
   auto timestamp = op.time_and_value.timestamp;
   auto val = op.time_and_value.value;
   std::ostringstream stmt;
@@ -267,7 +267,19 @@ void MySqlDB::Init() {
 
 void MySqlDB::Cleanup() { delete statements; }
 
-Status MySqlDB::Read(DataTable table, const std::vector<DB::Field> &key,
+Status MySqlDB::Ping() {
+  auto query = statements->sql_connection_.makeQuery("SELECT 1");
+  try {
+    query.execute();
+    query.store();
+  } catch (sql::MysqlInternalError e) {
+    std::cerr << e.getMysqlError() << std::endl;
+    return Status::kError;
+  }
+  return Status::kOK;
+}
+
+Status MySqlDB::Read(DataTable table, const Key &key,
                      std::vector<TimestampValue> &buffer) {
 
   bool row_found = false;
@@ -275,13 +287,9 @@ Status MySqlDB::Read(DataTable table, const std::vector<DB::Field> &key,
   sql::Nullable<int64_t> timestamp;
   if (table == DataTable::Edges) {
     auto &statement = statements->read_edge;
-    assert(key.size() == 3);
-    assert(key[0].name == "id1");
-    assert(key[1].name == "id2");
-    assert(key[2].name == "type");
-    int64_t id1 = key[0].value;
-    int64_t id2 = key[1].value;
-    int64_t type = key[2].value;
+    int64_t id1 = key.id1;
+    int64_t id2 = key.id2;
+    int64_t type = key.type;
     statement.bindParam(0, id1);
     statement.bindParam(1, id2);
     statement.bindParam(2, type);
@@ -298,9 +306,7 @@ Status MySqlDB::Read(DataTable table, const std::vector<DB::Field> &key,
     statement.fetch();
   } else {
     auto &statement = statements->read_object;
-    assert(key.size() == 1);
-    assert(key[0].name == "id");
-    int64_t id = key[0].value;
+    int64_t id = key.id1;
     statement.bindParam(0, id);
     statement.updateParamBindings();
     try {
@@ -322,25 +328,23 @@ Status MySqlDB::Read(DataTable table, const std::vector<DB::Field> &key,
   return Status::kOK;
 }
 
-Status MySqlDB::Scan(DataTable table, const std::vector<Field> &key, int n,
+Status MySqlDB::Scan(DataTable table, const Key &key, int n,
                      std::vector<TimestampValue> &buffer) {
   return Status::kNotImplemented;
 }
 
-Status MySqlDB::Update(DataTable table, const std::vector<Field> &key,
-                       TimestampValue const &value) {
+Status MySqlDB::Update(DataTable table, const Key &key,
+                       TimestampValueRef const &value) {
   int64_t timestamp = value.timestamp;
-  const char *val = value.value.c_str();
+  // statements bind NUL-terminated strings, which a value view is not
+  const std::string val_copy(value.value);
+  const char *val = val_copy.c_str();
 
   if (table == DataTable::Edges) {
-    assert(key.size() == 3);
-    assert(key[0].name == "id1");
-    assert(key[1].name == "id2");
-    assert(key[2].name == "type");
     auto &statement = statements->update_edge;
-    int64_t id1 = key[0].value;
-    int64_t id2 = key[1].value;
-    int64_t type = key[2].value;
+    int64_t id1 = key.id1;
+    int64_t id2 = key.id2;
+    int64_t type = key.type;
     statement.bindParam(0, timestamp);
     statement.bindParam(1, val);
     statement.bindParam(2, timestamp);
@@ -355,10 +359,8 @@ Status MySqlDB::Update(DataTable table, const std::vector<Field> &key,
       return Status::kError;
     }
   } else {
-    assert(key.size() == 1);
-    assert(key[0].name == "id");
     auto &statement = statements->update_object;
-    int64_t id = key[0].value;
+    int64_t id = key.id1;
     statement.bindParam(0, timestamp);
     statement.bindParam(1, val);
     statement.bindParam(2, timestamp);
@@ -374,15 +376,15 @@ Status MySqlDB::Update(DataTable table, const std::vector<Field> &key,
   return Status::kOK;
 }
 
-Status MySqlDB::Insert(DataTable table, const std::vector<Field> &key,
-                       TimestampValue const &value) {
+Status MySqlDB::Insert(DataTable table, const Key &key,
+                       TimestampValueRef const &value) {
   int64_t timestamp = value.timestamp;
-  const char *val = value.value.c_str();
+  // statements bind NUL-terminated strings, which a value view is not
+  const std::string val_copy(value.value);
+  const char *val = val_copy.c_str();
 
   if (table == DataTable::Objects) {
-    assert(key.size() == 1);
-    assert(key[0].name == "id");
-    int64_t id = key[0].value;
+    int64_t id = key.id1;
     auto &statement = statements->insert_object;
     statement.bindParam(0, id);
     statement.bindParam(1, timestamp);
@@ -395,13 +397,9 @@ Status MySqlDB::Insert(DataTable table, const std::vector<Field> &key,
       return Status::kError;
     }
   } else {
-    assert(key.size() == 3);
-    assert(key[0].name == "id1");
-    assert(key[1].name == "id2");
-    assert(key[2].name == "type");
-    int64_t id1 = key[0].value;
-    int64_t id2 = key[1].value;
-    int64_t type = key[2].value;
+    int64_t id1 = key.id1;
+    int64_t id2 = key.id2;
+    int64_t type = key.type;
     auto t = static_cast<EdgeType>(type);
     if (t == EdgeType::Other) {
       auto &statement = statements->insert_other;
@@ -595,19 +593,15 @@ Status MySqlDB::BatchInsertEdges(const std::vector<std::vector<Field>> &keys,
   return Status::kOK;
 }
 
-Status MySqlDB::Delete(DataTable table, const std::vector<Field> &key,
-                       TimestampValue const &value) {
+Status MySqlDB::Delete(DataTable table, const Key &key,
+                       TimestampValueRef const &value) {
 
   int64_t timestamp = value.timestamp;
   if (table == DataTable::Edges) {
-    assert(key.size() == 3);
-    assert(key[0].name == "id1");
-    assert(key[1].name == "id2");
-    assert(key[2].name == "type");
     auto &statement = statements->delete_edge;
-    int64_t id1 = key[0].value;
-    int64_t id2 = key[1].value;
-    std::string type = EdgeTypeToString(static_cast<EdgeType>(key[2].value));
+    int64_t id1 = key.id1;
+    int64_t id2 = key.id2;
+    std::string type = EdgeTypeToString(static_cast<EdgeType>(key.type));
     statement.bindParam(0, timestamp);
     statement.bindParam(1, id1);
     statement.bindParam(2, id2);
@@ -620,10 +614,8 @@ Status MySqlDB::Delete(DataTable table, const std::vector<Field> &key,
       return Status::kError;
     }
   } else {
-    assert(key.size() == 1);
-    assert(key[0].name == "id");
     auto &statement = statements->delete_object;
-    int64_t id = key[0].value;
+    int64_t id = key.id1;
 
     statement.bindParam(0, timestamp);
     statement.bindParam(1, id);
@@ -709,7 +701,7 @@ Status MySqlDB::ExecuteTransaction(const std::vector<DB_Operation> &operations,
       if (op.table == DataTable::Objects) {
         query << InsertObjectSQL(op);
       } else {
-        auto type = static_cast<EdgeType>(op.key[2].value);
+        auto type = static_cast<EdgeType>(op.key.type);
         if (type == EdgeType::Other) {
           query << InsertOtherSQL(op);
         } else if (type == EdgeType::Unique) {
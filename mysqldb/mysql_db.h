@@ -25,17 +25,19 @@ public:
 
   void Cleanup();
 
-  Status Read(DataTable table, const std::vector<Field> & key,
+  Status Ping();
+
+  Status Read(DataTable table, const Key &key,
               std::vector<TimestampValue> &buffer);
 
-  Status Scan(DataTable table, const std::vector<Field> & key, int n,
+  Status Scan(DataTable table, const Key &key, int n,
               std::vector<TimestampValue> &buffer);
 
-  Status Update(DataTable table, const std::vector<Field> &key,
-                TimestampValue const & value);
+  Status Update(DataTable table, const Key &key,
+                TimestampValueRef const & value);
 
-  Status Insert(DataTable table, const std::vector<Field> &key,
-                TimestampValue const & value);
+  Status Insert(DataTable table, const Key &key,
+                TimestampValueRef const & value);
 
   Status BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
                      std::vector<TimestampValue> const & values);
@@ -44,8 +46,8 @@ public:
                    const std::vector<Field> &ceiling_key, int n,
                    std::vector<std::vector<Field>> &key_buffer);
 
-  Status Delete(DataTable table, const std::vector<Field> &key,
-                TimestampValue const & value);
+  Status Delete(DataTable table, const Key &key,
+                TimestampValueRef const & value);
 
   Status Execute(const DB_Operation &operation,
                  std::vector<TimestampValue> &read_buffer,
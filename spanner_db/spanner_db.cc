@@ -64,68 +64,52 @@ namespace {
 
   namespace spanner = ::google::cloud::spanner;
 
-  inline spanner::KeySet BuildEdgeKeySet(std::vector<std::vector<benchmark::DB::Field>> const & keys) {
+  inline spanner::KeySet BuildEdgeKeySet(std::vector<benchmark::DB::Key> const & keys) {
     auto keyset = spanner::KeySet();
     for (auto const & key : keys) {
-      assert(key.size() == 3);
-      assert(key[0].name == "id1");
-      assert(key[1].name == "id2");
-      assert(key[2].name == "type");
       keyset = keyset.AddKey(
-        spanner::MakeKey(key[0].value,
-                         key[1].value,
-                         key[2].value)
+        spanner::MakeKey(key.id1,
+                         key.id2,
+                         key.type)
       );
     }
     return keyset;
   }
 
-  inline spanner::KeySet BuildObjectKeySet(std::vector<std::vector<benchmark::DB::Field>> const & keys) {
+  inline spanner::KeySet BuildObjectKeySet(std::vector<benchmark::DB::Key> const & keys) {
     auto keyset = spanner::KeySet();
     for (auto const & key : keys) {
-      assert(key.size() == 1);
-      assert(key[0].name == "id");
-      keyset = keyset.AddKey(spanner::MakeKey(key[0].value));
+      keyset = keyset.AddKey(spanner::MakeKey(key.id1));
     }
     return keyset;
   }
 
-  inline spanner::SqlStatement GetUpdateEdgeSql(std::vector<benchmark::DB::Field> const & key, 
-                                                benchmark::DB::TimestampValue const & timeval)
+  inline spanner::SqlStatement GetUpdateEdgeSql(benchmark::DB::Key const & key,
+                                                benchmark::DB::TimestampValueRef const & timeval)
   {
-    assert(key.size() == 3);
-    assert(key[0].name == "id1");
-    assert(key[1].name == "id2");
-    assert(key[2].name == "type");
     return spanner::SqlStatement(UPDATE_EDGE, {
-      {"id1", spanner::Value(key[0].value)},
-      {"id2", spanner::Value(key[1].value)},
-      {"type", spanner::Value(key[2].value)},
+      {"id1", spanner::Value(key.id1)},
+      {"id2", spanner::Value(key.id2)},
+      {"type", spanner::Value(key.type)},
       {"timestamp", spanner::Value(timeval.timestamp)},
-      {"value", spanner::Value(timeval.value)}
+      {"value", spanner::Value(std::string(timeval.value))}
     });
   }
 
-  inline spanner::SqlStatement GetUpdateObjectSql(std::vector<benchmark::DB::Field> const & key,
-                                                  benchmark::DB::TimestampValue const & timeval)
+  inline spanner::SqlStatement GetUpdateObjectSql(benchmark::DB::Key const & key,
+                                                  benchmark::DB::TimestampValueRef const & timeval)
   {
-    assert(key.size() == 1);
-    assert(key[0].name == "id");
     return spanner::SqlStatement(UPDATE_OBJECT, {
-      {"id", spanner::Value(key[0].value)},
+      {"id", spanner::Value(key.id1)},
       {"timestamp", spanner::Value(timeval.timestamp)},
-      {"value", spanner::Value(timeval.value)}
+      {"value", spanner::Value(std::string(timeval.value))}
     });
   }
 
-  inline spanner::SqlStatement GetInsertEdgeSql(std::vector<benchmark::DB::Field> const & key,
-                                                benchmark::DB::TimestampValue const & timeval)
+  inline spanner::SqlStatement GetInsertEdgeSql(benchmark::DB::Key const & key,
+                                                benchmark::DB::TimestampValueRef const & timeval)
   {
-    assert(key.size() == 3);
-    assert(key[0].name == "id1");
-    assert(key[1].name == "id2");
-    assert(key[2].name == "type");
-    benchmark::EdgeType type = static_cast<benchmark::EdgeType>(key[2].value);
+    benchmark::EdgeType type = static_cast<benchmark::EdgeType>(key.type);
     std::string read_string;
     if (type == benchmark::EdgeType::Other) {
       read_string = INSERT_EDGE_OTHER;
@@ -139,49 +123,41 @@ namespace {
       throw std::runtime_error("Invalid edge type!");
     }
     return spanner::SqlStatement(INSERT_EDGE + read_string, {
-      {"id1", spanner::Value(key[0].value)},
-      {"id2", spanner::Value(key[1].value)},
-      {"type", spanner::Value(key[2].value)},
+      {"id1", spanner::Value(key.id1)},
+      {"id2", spanner::Value(key.id2)},
+      {"type", spanner::Value(key.type)},
       {"timestamp", spanner::Value(timeval.timestamp)},
-      {"value", spanner::Value(timeval.value)}
+      {"value", spanner::Value(std::string(timeval.value))}
     });
   }
 
-  inline spanner::SqlStatement GetInsertObjectSql(std::vector<benchmark::DB::Field> const & key,
-                                                  benchmark::DB::TimestampValue const & timeval)
+  inline spanner::SqlStatement GetInsertObjectSql(benchmark::DB::Key const & key,
+                                                  benchmark::DB::TimestampValueRef const & timeval)
   {
-    assert(key.size() == 1);
-    assert(key[0].name == "id");
     return spanner::SqlStatement(INSERT_OBJECT, {
-      {"id", spanner::Value(key[0].value)},
+      {"id", spanner::Value(key.id1)},
       {"timestamp", spanner::Value(timeval.timestamp)},
-      {"value", spanner::Value(timeval.value)}
+      {"value", spanner::Value(std::string(timeval.value))}
     });
   }
 
-  inline spanner::SqlStatement GetDeleteEdgeSql(std::vector<benchmark::DB::Field> const & key,
-                                                benchmark::DB::TimestampValue const & timeval)
+  inline spanner::SqlStatement GetDeleteEdgeSql(benchmark::DB::Key const & key,
+                                                benchmark::DB::TimestampValueRef const & timeval)
   {
-    assert(key.size() == 3);
-    assert(key[0].name == "id1");
-    assert(key[1].name == "id2");
-    assert(key[2].name == "type");
     return spanner::SqlStatement(DELETE_EDGE, {
-      {"id1", spanner::Value(key[0].value)},
-      {"id2", spanner::Value(key[1].value)},
-      {"type", spanner::Value(key[2].value)},
+      {"id1", spanner::Value(key.id1)},
+      {"id2", spanner::Value(key.id2)},
+      {"type", spanner::Value(key.type)},
       {"timestamp", spanner::Value(timeval.timestamp)}
     });
 
   }
 
-  inline spanner::SqlStatement GetDeleteObjectSql(std::vector<benchmark::DB::Field> const & key,
-                                                  benchmark::DB::TimestampValue const & timeval)
+  inline spanner::SqlStatement GetDeleteObjectSql(benchmark::DB::Key const & key,
+                                                  benchmark::DB::TimestampValueRef const & timeval)
   {
-    assert(key.size() == 1);
-    assert(key[0].name == "id");
     return spanner::SqlStatement(DELETE_OBJECT, {
-      {"id", spanner::Value(key[0].value)},
+      {"id", spanner::Value(key.id1)},
       {"timestamp", spanner::Value(timeval.timestamp)},
     });
   }
@@ -238,6 +214,17 @@ void SpannerDB::Cleanup() {
   delete info;
 }
 
+Status SpannerDB::Ping() {
+  auto rows = info->client.ExecuteQuery(spanner::SqlStatement("SELECT 1"));
+  for (auto const & row : spanner::StreamOf<std::tuple<int64_t>>(rows)) {
+    if (!row) {
+      std::cerr << "Ping Failed: " << row.status().message() << std::endl;
+      return Status::kError;
+    }
+  }
+  return Status::kOK;
+}
+
 Status SpannerDB::Execute(const DB_Operation &op, std::vector<TimestampValue> &read_buffer, bool txn_op) {
   switch (op.operation) {
     case Operation::READ:
@@ -259,20 +246,20 @@ Status SpannerDB::ExecuteTransaction(const std::vector<DB_Operation> &operations
                                      bool read_only)
 {
   assert(!operations.empty());
-  std::vector<std::vector<Field>> edge_keys;
-  std::vector<std::vector<Field>> object_keys;
+  std::vector<Key> edge_keys;
+  std::vector<Key> object_keys;
   std::unordered_set<int64_t> edge_ids;
   std::unordered_set<int64_t> object_ids;
   if (read_only) {
     using RowType = std::tuple<int64_t, std::string>;
     for (auto const & op : operations) {
       assert(op.operation == Operation::READ);
-      if (op.table == DataTable::Edges && edge_ids.find(op.key[0].value) == edge_ids.end()) {
+      if (op.table == DataTable::Edges && edge_ids.find(op.key.id1) == edge_ids.end()) {
         edge_keys.emplace_back(op.key);
-        edge_ids.insert(op.key[0].value);
-      } else if (object_ids.find(op.key[0].value) == object_ids.end()) {
+        edge_ids.insert(op.key.id1);
+      } else if (object_ids.find(op.key.id1) == object_ids.end()) {
         object_keys.emplace_back(op.key);
-        object_ids.insert(op.key[0].value);
+        object_ids.insert(op.key.id1);
       }
     }
     auto read_only_txn = spanner::MakeReadOnlyTransaction();
@@ -345,7 +332,7 @@ Status SpannerDB::ExecuteTransaction(const std::vector<DB_Operation> &operations
   }
 }
 
-Status SpannerDB::Read(DataTable table, const std::vector<Field> &key, std::vector<TimestampValue> & buffer)
+Status SpannerDB::Read(DataTable table, const Key &key, std::vector<TimestampValue> & buffer)
 {
 
   using RowType = std::tuple<int64_t, std::string>;
@@ -369,15 +356,15 @@ Status SpannerDB::Read(DataTable table, const std::vector<Field> &key, std::vect
 }
 
 Status SpannerDB::Scan(DataTable table,
-                      const std::vector<Field> &key,
+                      const Key &key,
                       int n,
                       std::vector<TimestampValue> &buffer)
 {
   return Status::kNotImplemented;
 }
 
-Status SpannerDB::Insert(DataTable table, const std::vector<Field> &key,
-                         const TimestampValue & timeval) 
+Status SpannerDB::Insert(DataTable table, const Key &key,
+                         const TimestampValueRef & timeval) 
 {
   spanner::SqlStatement insert_stmt = table == DataTable::Edges 
       ? GetInsertEdgeSql(key, timeval)
@@ -397,8 +384,8 @@ Status SpannerDB::Insert(DataTable table, const std::vector<Field> &key,
   return Status::kOK;
 }
 
-Status SpannerDB::Update(DataTable table, const std::vector<Field> &key,
-                         const TimestampValue &timeval) {
+Status SpannerDB::Update(DataTable table, const Key &key,
+                         const TimestampValueRef &timeval) {
 
   spanner::SqlStatement update_stmt = table == DataTable::Edges
       ? GetUpdateEdgeSql(key, timeval)
@@ -418,8 +405,8 @@ Status SpannerDB::Update(DataTable table, const std::vector<Field> &key,
   return Status::kOK;
 }
 
-Status SpannerDB::Delete(DataTable table, const std::vector<Field> &key,
-                       const TimestampValue & timeval) {
+Status SpannerDB::Delete(DataTable table, const Key &key,
+                       const TimestampValueRef & timeval) {
 
   spanner::SqlStatement delete_stmt = table == DataTable::Edges
       ? GetDeleteEdgeSql(key, timeval)
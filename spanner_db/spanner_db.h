@@ -25,26 +25,28 @@ public:
 
   void Cleanup();
 
+  Status Ping();
+
   Status Read(DataTable table,
-              const std::vector<DB::Field> &key,
+              const Key &key,
               std::vector<TimestampValue> &buffer);
 
   Status Scan(DataTable table,
-              const std::vector<DB::Field> &key,
+              const Key &key,
               int n,
               std::vector<TimestampValue> &buffer);
 
   Status Update(DataTable table,
-                const std::vector<DB::Field> &key,
-                TimestampValue const & value);
+                const Key &key,
+                TimestampValueRef const & value);
 
   Status Insert(DataTable table,
-                const std::vector<DB::Field> &key,
-                TimestampValue const & value);
+                const Key &key,
+                TimestampValueRef const & value);
 
   Status Delete(DataTable table,
-                const std::vector<DB::Field> &key,
-                TimestampValue const & value);
+                const Key &key,
+                TimestampValueRef const & value);
 
   Status Execute(const DB_Operation &operation,
                  std::vector<TimestampValue> & read_buffer,
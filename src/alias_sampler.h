@@ -0,0 +1,97 @@
+#ifndef ALIAS_SAMPLER_H_
+#define ALIAS_SAMPLER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace benchmark {
+
+///
+/// Draws indices with probability proportional to a list of weights, like
+/// std::discrete_distribution, but in constant time: Vose's alias method splits
+/// the weights into equally likely columns, each holding at most two indices,
+/// so a draw picks a column and then one of its two indices. std::discrete_distribution
+/// binary searches the cumulative weights instead, which adds up for the
+/// roughly thousand shard weights of a config.
+///
+/// Sampling is const and allocation-free, so one sampler can be shared by all
+/// client threads.
+///
+class AliasSampler {
+ public:
+  // Always draws 0, like a default std::discrete_distribution.
+  AliasSampler() : AliasSampler(std::vector<double>{1}) { }
+
+  // Weights must not be negative. An empty list draws 0, and weights that are
+  // all zero draw uniformly.
+  explicit AliasSampler(std::vector<double> const &weights) {
+    size_t n = std::max<size_t>(weights.size(), 1);
+    double total = 0;
+    for (double weight : weights) {
+      if (!(weight >= 0)) {
+        throw std::invalid_argument("Sampling weights must not be negative");
+      }
+      total += weight;
+    }
+    // scaled so that the average column holds exactly 1
+    std::vector<double> scaled(n, 1);
+    if (total > 0) {
+      for (size_t i = 0; i < weights.size(); ++i) {
+        scaled[i] = weights[i] * n / total;
+      }
+    }
+
+    threshold_.assign(n, kOne);
+    alias_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      alias_[i] = static_cast<uint32_t>(i);
+    }
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (size_t i = 0; i < n; ++i) {
+      (scaled[i] < 1 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+    // fill up each small column with the remainder of a large one
+    while (!small.empty() && !large.empty()) {
+      uint32_t s = small.back();
+      uint32_t l = large.back();
+      small.pop_back();
+      threshold_[s] = static_cast<uint64_t>(scaled[s] * kOne);
+      alias_[s] = l;
+      scaled[l] -= 1 - scaled[s];
+      if (scaled[l] < 1) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // whatever is left is 1 up to rounding error, and keeps its own index
+  }
+
+  // Draws an index with a single call to @param gen, which must produce 32
+  // uniform bits (e.g. std::mt19937).
+  template <class URNG>
+  int operator()(URNG &gen) const {
+    static_assert(URNG::max() - URNG::min() == 0xFFFFFFFFull, "AliasSampler needs a 32-bit generator");
+    // the high half picks the column, the low half the index within it
+    uint64_t r = static_cast<uint64_t>(gen() - URNG::min()) * threshold_.size();
+    uint32_t column = static_cast<uint32_t>(r >> 32);
+    return (r & 0xFFFFFFFFull) < threshold_[column] ? column : alias_[column];
+  }
+
+  size_t size() const {
+    return threshold_.size();
+  }
+
+ private:
+  static constexpr uint64_t kOne = 1ull << 32;
+
+  // a column keeps its own index if the low half of a draw is below this
+  std::vector<uint64_t> threshold_;
+  std::vector<uint32_t> alias_;
+};
+
+} // benchmark
+
+#endif // ALIAS_SAMPLER_H_
@@ -12,6 +12,7 @@
 #include "utils.h"
 #include "timer.h"
 #include "client.h"
+#include "client_pool.h"
 #include "measurements.h"
 #include "workload.h"
 #include "countdown_latch.h"
@@ -19,6 +20,10 @@
 #include "workload.h"
 #include "loaders.h"
 #include "experiment_loader.h"
+#include "metrics_server.h"
+#include "results_writer.h"
+#include "saturation_search.h"
+#include "steady_state.h"
 #include "constants.h"
 #include "test_workload.h"
 
@@ -120,6 +125,10 @@ void ParseCommandLine(int argc, const char *argv[], benchmark::utils::Properties
     } else if (strcmp(argv[argindex], "-load") == 0) {
       argindex++;
       props.SetProperty("run", "false");
+    } else if (strcmp(argv[argindex], "-search") == 0) {
+      argindex++;
+      props.SetProperty("run", "true");
+      props.SetProperty("search", "true");
     } else if (strcmp(argv[argindex], "-test") == 0) {
       argindex++;
       props.SetProperty("test", "true");
@@ -136,49 +145,36 @@ void ParseCommandLine(int argc, const char *argv[], benchmark::utils::Properties
   }
 }
 
-namespace OpsCounts {
-    uint64_t completed_ops = 0;
-    uint64_t failed_ops = 0;
-    uint64_t overtime_ops = 0;
-}
-
+// Prints the measured statistics so far and closes an interval every
+// `interval` seconds. Warmup is handled by the client threads, which tag
+// each request with its phase, so this thread is optional unless the warmup
+// is adaptive: then every warmup interval is passed to the detector, and the
+// warmup ends as soon as it reports a steady state.
 void StatusThread(benchmark::Measurements *measurements
                   , CountDownLatch *latch
                   , int interval
-                  , double warmup_period
-                  , benchmark::utils::Timer<double> *timer) {
-  // warmup_period is the time (in seconds) we will omit from our measurements
-  // to account for database warmup; we will reset measurements once the warmup period
-  // is over. this measurement does not have to be precise, we respect the period given
-  // to the nearest interval length
+                  , benchmark::SteadyStateDetector *detector) {
   using namespace std::chrono;
   time_point<system_clock> start = system_clock::now();
   bool done = false;
-  bool reset_post_warmup = false;
-  while (1) {
+  while (!done) {
+    // the first interval closes after a full interval rather than right away
+    done = latch->AwaitFor(interval);
     time_point<system_clock> now = system_clock::now();
     std::time_t now_c = system_clock::to_time_t(now);
     duration<double> elapsed_time = now - start;
-    if (!reset_post_warmup && elapsed_time.count() > warmup_period) {
-      measurements->Reset();
-      timer->Start();
-      // TODO(jchan): Resetting these counts doesn't work as intended, since
-      // the client threads aren't aware of this reset.
-      OpsCounts::completed_ops = 0;
-      OpsCounts::failed_ops = 0;
-      OpsCounts::overtime_ops = 0;
-      reset_post_warmup = true;
-    }
+    benchmark::IntervalStats interval_stats = measurements->CloseInterval();
     std::cout << std::put_time(std::localtime(&now_c), "%F %T") << ' '
               << static_cast<long long>(elapsed_time.count()) << " sec: ";
 
     std::cout << measurements->GetStatusMsg() << std::endl;
-
-    if (done) {
-      break;
+    std::cout << "  interval " << benchmark::Measurements::FormatInterval(interval_stats) << std::endl;
+    if (detector != nullptr && interval_stats.warmup && detector->AddInterval(interval_stats)) {
+      measurements->EndWarmup();
+      std::cout << "Steady state reached (" << detector->Describe() << "); ending warmup after "
+                << measurements->WarmupSeconds() << " sec" << std::endl;
     }
-    done = latch->AwaitFor(interval);
-  };
+  }
 }
 
 inline bool StrStartWith(const char *str, const char *pre) {
@@ -193,12 +189,15 @@ void UsageMessage(const char *command) {
       "  -t: run the transactions phase of the workload\n"
       "  -run: same as -t\n"
       "  -test: run test_workload\n"
+      "  -search: run the transactions phase as a search for the highest throughput\n"
+      "           that meets a latency SLO (see search.* properties) instead of -e\n"
       "  -load-threads n: number of threads for batch inserts (load) or batch reads (run) (default: 1)\n"
       "  -db dbname: specify the name of the DB to use (default: basic)\n"
       "  -p propertyfile: load properties from the given file. Multiple files can\n"
       "                   be specified, and will be processed in the order specified\n"
       "  -c configfile: load workload config from the given file\n"
-      "  -e experimentfile: each line gives num_threads, num_ops, and target throughput for an experiment\n"
+      "  -e experimentfile: each line gives num_threads, warmup_len, exp_len and optionally\n"
+      "                     target throughput (ops/sec) for an experiment\n"
       "  -property name=value: specify a property to be passed to the DB and workloads\n"
       "                         multiple properties can be specified, and override any\n"
       "                         values in the propertyfile\n"
@@ -216,6 +215,186 @@ inline void ClearDBs(std::vector<benchmark::DB *> dbs) {
   dbs.clear();
 }
 
+// Runs a single experiment on the client pool, resized to the experiment's
+// number of threads, and prints its summary.
+benchmark::ExperimentResult RunExperiment(benchmark::utils::Properties &props,
+                                          benchmark::Workload &wl,
+                                          benchmark::Measurements &measurements,
+                                          benchmark::ClientPool &pool,
+                                          benchmark::ExperimentInfo const &experiment) {
+  // controls if we spin or sleep when we want to slow down to meet target throughput
+  const bool spin = props.GetProperty("spin", "false") == "true";
+
+  // open-loop clients send requests as a Poisson process unless arrival=fixed
+  const std::string arrival = props.GetProperty("arrival", "poisson");
+  if (arrival != "poisson" && arrival != "fixed") {
+    throw std::invalid_argument("Unknown arrival process '" + arrival + "'; expected poisson or fixed");
+  }
+  const bool poisson_arrivals = arrival == "poisson";
+
+  // read hardware counters of the client threads with perf_event_open
+  const bool count_perf = props.GetProperty("perf.counters", "false") == "true";
+
+  const bool show_status = (props.GetProperty("status", "true") == "true");
+  const int status_interval = std::stoi(props.GetProperty("status.interval", "10"));
+
+  // clients keep sending for this long after the measured phase, so that the
+  // last measured requests do not see the load drop off
+  const double cooldown_len = std::stod(props.GetProperty("cooldown_len", "0"));
+
+  // with an adaptive warmup, warmup_len is only the upper bound
+  std::unique_ptr<benchmark::SteadyStateDetector> steady_state = benchmark::SteadyStateDetector::Create(props);
+  if (steady_state && !show_status) {
+    throw std::invalid_argument("warmup.adaptive needs the status thread; do not set status=false");
+  }
+
+  benchmark::utils::Timer<double> timer;
+
+  int num_experiment_threads = experiment.num_threads;
+  double exp_len = experiment.exp_len;
+  double warmup_len = experiment.warmup_len;
+  // total offered load in ops/sec across all client threads; 0 runs closed-loop
+  double target_throughput = experiment.target_throughput;
+  std::cout << "Running experiment: " << num_experiment_threads << " threads, " <<
+    warmup_len << " seconds (warmup), " << exp_len << " seconds (experiment)";
+  if (target_throughput > 0) {
+    std::cout << ", " << target_throughput << " ops/sec (target)";
+  }
+  std::cout << std::endl;
+
+  // connections of clients kept from the previous experiment stay open; new
+  // ones are pinged until they are ready
+  pool.Resize(num_experiment_threads);
+
+  CountDownLatch latch(num_experiment_threads);
+  // exp_len includes the warmup
+  measurements.Reset(warmup_len, exp_len - warmup_len, cooldown_len);
+  timer.Start();
+  std::future<void> status_future;
+
+  // launch status update thread
+  if (show_status) {
+    status_future = std::async(std::launch::async, StatusThread,
+                                &measurements, &latch, status_interval, steady_state.get());
+  }
+
+  // all clients start together and return once the experiment is over
+  std::vector<benchmark::ClientThreadInfo> client_infos = pool.Run(
+    [&](int client, benchmark::DB *db) {
+      return benchmark::ClientThread(
+        db,
+        &wl,
+        &measurements,
+        target_throughput / num_experiment_threads,
+        poisson_arrivals,
+        client % std::thread::hardware_concurrency(),
+        false, // initialize workload, not used rn
+        false, // initialize db, we're doing this in CreateDB
+        false,  // cleanup db, the pool does it
+        !spin, // sleep on waits (vs idling)
+        count_perf,
+        &latch);
+    });
+  assert((int)client_infos.size() == num_experiment_threads);
+
+  // client threads count their requests after warmup themselves
+  benchmark::PerfCounts perf;
+  uint64_t client_ops = 0;
+  uint64_t failed_ops = 0;
+  uint64_t overtime_ops = 0;
+  for (benchmark::ClientThreadInfo const &info : client_infos) {
+    perf += info.perf;
+    client_ops += info.completed_ops + info.failed_ops;
+    failed_ops += info.failed_ops;
+    overtime_ops += info.overtime_ops;
+  }
+  double runtime = timer.End();
+  double warmup_excluded_runtime = measurements.MeasuredSeconds();
+
+  if (show_status) {
+    status_future.wait();
+  } else {
+    measurements.CloseInterval(); // the time series is the whole experiment
+  }
+
+  benchmark::MeasurementsSnapshot snapshot = measurements.GetSnapshot();
+  benchmark::ExperimentResult result(experiment, props, snapshot);
+  result.runtime_sec = runtime;
+  result.measured_runtime_sec = warmup_excluded_runtime;
+  result.warmup_sec = measurements.WarmupSeconds();
+  result.throughput = result.completed_ops / warmup_excluded_runtime;
+  result.goodput = snapshot.TotalOutcome(benchmark::RequestOutcome::OK) / warmup_excluded_runtime;
+  result.attempt_throughput = (snapshot.TotalRequests() + snapshot.TotalRetries()) / warmup_excluded_runtime;
+  result.failed_ops = failed_ops;
+  result.overtime_ops = overtime_ops;
+  result.intervals = measurements.GetIntervals();
+  result.perf = perf;
+  result.perf_ops = client_ops;
+  result.client_threads = benchmark::SummarizeClientThreads(client_infos);
+  result.client_imbalance = benchmark::ClientImbalance(result.client_threads);
+  result.shards = benchmark::ShardBreakdown(snapshot, warmup_excluded_runtime);
+  result.hotness_buckets = benchmark::HotnessBreakdown(snapshot, warmup_excluded_runtime);
+
+  std::cout << "Experiment description: " << num_experiment_threads
+            << " threads, " << warmup_len << " seconds (warmup), "
+            << exp_len << " seconds (experiment)";
+  if (target_throughput > 0) {
+    std::cout << ", " << target_throughput << " ops/sec (target)";
+  }
+  std::cout << std::endl;
+  std::cout << "Total runtime (sec): " << runtime << std::endl;
+  std::cout << "Warmup (sec): " << result.warmup_sec;
+  if (steady_state) {
+    std::cout << (result.warmup_sec < warmup_len ? " (adaptive, steady state reached)"
+                                                 : " (adaptive, upper bound reached)");
+  }
+  std::cout << std::endl;
+  std::cout << "Runtime excluding warmup (sec): " << warmup_excluded_runtime << std::endl;
+  std::cout << "Total completed operations excluding warmup: " << result.completed_ops << std::endl;
+  std::cout << "Throughput excluding warmup: " << result.throughput << std::endl;
+  // Overtime operations are requests sent later than scheduled; they only
+  // occur when a target throughput is set.
+  std::cout << "Number of overtime operations: " << result.overtime_ops << std::endl;
+  std::cout << "Number of failed operations: " << result.failed_ops << std::endl;
+  std::cout << "Number of contention retries: " << result.contention << std::endl;
+  std::cout << "Goodput excluding warmup (successful requests/sec): " << result.goodput << std::endl;
+  std::cout << "Attempts per second including retries: " << result.attempt_throughput << std::endl;
+  std::cout << "Abort rate (attempts hitting contention): " << result.abort_rate << std::endl;
+  std::cout << "Request outcomes:" << benchmark::Measurements::FormatOutcomes(snapshot) << std::endl;
+  std::cout << "Cache Hit Rate: " << result.cache_hit_rate << std::endl;
+  if (count_perf) {
+    if (!perf.AnyValid()) {
+      std::cerr << "No perf counters could be opened; check /proc/sys/kernel/perf_event_paranoid"
+                << std::endl;
+    }
+    std::cout << "Client hardware counters per request: " << perf.FormatPerOp(client_ops) << std::endl;
+  }
+  std::cout << benchmark::Measurements::FormatStatusMsg(snapshot) << std::endl;
+  std::cout << "Cache latencies:" << benchmark::Measurements::FormatCacheLatency(snapshot) << std::endl;
+  if (props.GetProperty("measurements.profile", "false") == "true") {
+    std::cout << "Request phase profile:" << benchmark::Measurements::FormatProfile(snapshot) << std::endl;
+  }
+  std::cout << "Transaction latencies by size:"
+            << benchmark::Measurements::FormatTxnSizeLatency(snapshot) << std::endl;
+  if (target_throughput > 0) {
+    std::cout << "Uncorrected (service time) latencies: "
+              << benchmark::Measurements::FormatStatusMsg(snapshot.uncorrected_latency) << std::endl;
+  }
+  std::cout << "Client threads:" << std::endl;
+  benchmark::PrintClientThreads(std::cout, result.client_threads, result.client_imbalance);
+  std::cout << "Interval time series:" << std::endl;
+  benchmark::Measurements::PrintIntervals(std::cout, result.intervals);
+  if (!result.shards.empty()) {
+    std::cout << "Shard hotness breakdown:" << std::endl;
+    benchmark::Measurements::PrintShards(std::cout, result.hotness_buckets);
+    std::cout << "Per-shard breakdown:" << std::endl;
+    benchmark::Measurements::PrintShards(std::cout, result.shards);
+  }
+  std::cout << std::endl;
+
+  return result;
+}
+
 void RunTransactions(benchmark::utils::Properties & props) {
   const int num_threads = std::stoi(props.GetProperty("threadcount", "1"));
 
@@ -224,28 +403,35 @@ void RunTransactions(benchmark::utils::Properties & props) {
   std::string object_table = props.GetProperty("object_table", "objects");
   std::string edge_table = props.GetProperty("edge_table", "edges");
 
-  benchmark::Measurements measurements;
-
-  // controls if we spin or sleep when we want to slow down to meet target throughput
-  const bool spin = props.GetProperty("spin", "false") == "true";
-
-  // load in experiments from experiment file
-  if  (props.GetProperty("experiment_path", "missing") == "missing") {
-    throw std::runtime_error("Must specify an experiment file");
-  }
-  std::vector<benchmark::ExperimentInfo> experiments = benchmark::LoadExperiments(props.GetProperty("experiment_path"));
+  benchmark::Measurements measurements(props);
+  // serves the measurements to scrapers for the whole run if metrics.port is set
+  std::unique_ptr<benchmark::MetricsServer> metrics_server =
+    benchmark::MetricsServer::Create(props, &measurements);
 
+  // a saturation search picks its own experiments instead of reading them from a file
+  std::unique_ptr<benchmark::SaturationSearch> search;
+  std::vector<benchmark::ExperimentInfo> experiments;
   std::vector<int> thread_counts {0, num_threads};
-  for (auto & experiment : experiments) {
-    thread_counts.push_back(experiment.num_threads);
+  if (props.GetProperty("search", "false") == "true") {
+    search = std::make_unique<benchmark::SaturationSearch>(props);
+    thread_counts.push_back(search->MaxThreads());
+  } else {
+    // load in experiments from experiment file
+    if  (props.GetProperty("experiment_path", "missing") == "missing") {
+      throw std::runtime_error("Must specify an experiment file");
+    }
+    // target_throughput applies to experiments that do not set their own
+    experiments = benchmark::LoadExperiments(
+      props.GetProperty("experiment_path"), std::stod(props.GetProperty("target_throughput", "0")));
+    for (auto & experiment : experiments) {
+      thread_counts.push_back(experiment.num_threads);
+    }
+    benchmark::DescribeExperiments(experiments);
   }
 
   int max_concurrent_connections = *std::max_element(thread_counts.begin(), thread_counts.end());
   props.SetProperty("max_concurrent_connections", std::to_string(max_concurrent_connections));
 
-
-  benchmark::DescribeExperiments(experiments);
-
   // initialize DBs for batch reads
   std::vector<benchmark::DB *> dbs;
   for (int i = 0; i < num_threads; i++) {
@@ -309,7 +495,7 @@ void RunTransactions(benchmark::utils::Properties & props) {
   }
 
   // Combine all loaded edges and form workload distributions
-  benchmark::TraceGeneratorWorkload wl {props, loaders};
+  benchmark::TraceGeneratorWorkload wl {props, loaders, &measurements};
 
   std::cout << "Number of failed batch reads: " << invalid_batch_reads << std::endl;
   std::cout << "Done with batch read phase!" << std::endl;
@@ -319,109 +505,33 @@ void RunTransactions(benchmark::utils::Properties & props) {
   std::cout << "Sleeping after batch reads." << std::endl;
   std::this_thread::sleep_for(std::chrono::seconds(10));
 
-  const bool show_status = (props.GetProperty("status", "true") == "true");
-  if (!show_status) {
-    throw std::runtime_error("Status thread is needed to clear data from warmup period.");
-  }
-  const int status_interval = std::stoi(props.GetProperty("status.interval", "10"));
-
-  benchmark::utils::Timer<double> timer;
-  benchmark::utils::Timer<double> warmup_excluded_timer;
-
-  std::string experiment_path;
-  if ((experiment_path=props.GetProperty("experiment_path", "missing")) == "missing") {
-      throw std::invalid_argument("No experiments path provided!");
-  }
+  std::unique_ptr<benchmark::ResultsWriter> results_writer = benchmark::ResultsWriter::Create(props);
 
   if (std::thread::hardware_concurrency() == 0) {
     throw std::runtime_error("Compiler does not support std::thread::hardware_concurrency");
   }
 
-  for (benchmark::ExperimentInfo & experiment : experiments) {
-    int num_experiment_threads = experiment.num_threads;
-    double exp_len = experiment.exp_len;
-    double warmup_len = experiment.warmup_len;
-    std::cout << "Running experiment: " << num_experiment_threads << " threads, " <<
-      warmup_len << " seconds (warmup), " << exp_len << " seconds (experiment)" << std::endl;
-
-    std::vector<benchmark::DB *> experiment_dbs;
-    for (int i = 0; i < num_experiment_threads; i++) {
-        benchmark::DB *db = benchmark::DBFactory::CreateDB(&props, &measurements);
-        if (db == nullptr) {
-            std::cerr << "Unknown database name " << props["dbname"] << std::endl;
-            exit(1);
-        }
-        experiment_dbs.push_back(db);
-    }
-
-    // for TiDB at least, this was needed because connections take time to form
-    // might need to adjust
-    std::cout << "Sleeping after sending DB connections." << std::endl;
-    std::this_thread::sleep_for(std::chrono::seconds(30));
-
-    CountDownLatch latch(num_experiment_threads);
-    measurements.Reset();
-    timer.Start();
-    OpsCounts::completed_ops = OpsCounts::failed_ops = OpsCounts::overtime_ops = 0;
-    warmup_excluded_timer.Start();
-    std::future<void> status_future;
-
-    // launch status update thread
-    if (show_status) {
-      status_future = std::async(std::launch::async, StatusThread,
-                                  &measurements, &latch, status_interval, warmup_len,
-                                  &warmup_excluded_timer);
-    }
+  // client threads and their connections are reused across experiments
+  benchmark::ClientPool pool(&props, &measurements);
 
-    std::vector<std::future<benchmark::ClientThreadInfo>> client_threads;
-    for (int i = 0; i < num_experiment_threads; ++i) {
-      client_threads.emplace_back(std::async(
-        std::launch::async,
-        benchmark::ClientThread, experiment_dbs[i],
-        &wl,
-        exp_len,
-        i % std::thread::hardware_concurrency(),
-        false, // initialize workload, not used rn
-        false, // initialize db, we're doing this in CreateDB
-        false,  // cleanup db, we do it separately
-        !spin, // sleep on waits (vs idling)
-        &latch
-      ));
+  auto run_experiment = [&](benchmark::ExperimentInfo const &experiment) {
+    if (metrics_server) {
+      metrics_server->SetExperiment(experiment);
     }
-    assert((int)client_threads.size() == num_experiment_threads);
-
-    for (auto &n : client_threads) {
-      assert(n.valid());
-      benchmark::ClientThreadInfo info = n.get();
-      OpsCounts::completed_ops += info.completed_ops;
-      OpsCounts::overtime_ops += info.overtime_ops;
-      OpsCounts::failed_ops += info.failed_ops;
-    }
-    double runtime = timer.End();
-    double warmup_excluded_runtime = warmup_excluded_timer.End();
-
-    if (show_status) {
-      status_future.wait();
+    benchmark::ExperimentResult result = RunExperiment(props, wl, measurements, pool, experiment);
+    if (results_writer) {
+      results_writer->Add(result);
     }
+    return result;
+  };
 
-    std::cout << "Experiment description: " << num_experiment_threads
-              << " threads, " << warmup_len << " seconds (warmup), "
-              << exp_len << " seconds (experiment)" << std::endl;
-    std::cout << "Total runtime (sec): " << runtime << std::endl;
-    std::cout << "Runtime excluding warmup (sec): " << warmup_excluded_runtime << std::endl;
-    std::cout << "Total completed operations excluding warmup: " << measurements.GetTotalNumOps() << std::endl;
-    std::cout << "Throughput excluding warmup: " << measurements.GetTotalNumOps()/warmup_excluded_runtime << std::endl;
-    // TODO(jchan): Overtime operations aren't particularly meaningful anymore
-    // now that we've removed target throughput.
-    std::cout << "Number of overtime operations: " << OpsCounts::overtime_ops << std::endl;
-    std::cout << "Number of failed operations: " << OpsCounts::failed_ops << std::endl;
-    std::cout << "Cache Hit Rate: " << measurements.GetCacheHitRate() << std::endl;
-    std::cout << measurements.GetStatusMsg() << std::endl;
-    std::cout << std::endl;
-
-    ClearDBs(experiment_dbs);
-    // sleep between experiments
-    std::this_thread::sleep_for(std::chrono::seconds(10));
+  if (search) {
+    std::vector<benchmark::SearchProbe> probes = search->Run(run_experiment);
+    search->PrintCurve(std::cout, probes);
+    return;
+  }
+  for (benchmark::ExperimentInfo const & experiment : experiments) {
+    run_experiment(experiment);
   }
 }
 
@@ -434,7 +544,7 @@ void RunBatchInsert(benchmark::utils::Properties & props) {
   std::string object_table = props.GetProperty("object_table", "objects");
   std::string edge_table = props.GetProperty("edge_table", "edges");
 
-  benchmark::Measurements measurements;
+  benchmark::Measurements measurements(props);
   benchmark::TraceGeneratorWorkload wl {props};
 
   // initialize DBs
@@ -483,7 +593,7 @@ void RunBatchInsert(benchmark::utils::Properties & props) {
 
 void RunTestWorkload(benchmark::utils::Properties & props) {
   props.SetProperty("max_concurrent_connections", "1");
-  benchmark::Measurements msmnts;
+  benchmark::Measurements msmnts(props);
   benchmark::DB *db = benchmark::DBFactory::CreateDB(&props, &msmnts);
   benchmark::TestWorkload twl;
   twl.Init(*db);
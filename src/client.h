@@ -3,66 +3,118 @@
 
 #include <string>
 #include <chrono>
+#include <random>
 #include <thread>
 #include "db.h"
 #include "workload.h"
 #include "utils.h"
 #include "countdown_latch.h"
+#include "client_stats.h"
 #include "constants.h"
+#include "measurements.h"
+#include "timer.h"
 
 namespace benchmark {
 
-struct ClientThreadInfo {
-  int completed_ops;
-  int overtime_ops;
-  int failed_ops;
-};
-
+// Runs requests against db until the experiment set up by
+// measurements->Reset ends, tagging each request with the phase it is sent in;
+// only measured requests count toward the returned ClientThreadInfo. With a positive
+// target_ops_per_sec the thread runs open-loop: requests are scheduled
+// independently of how long earlier requests took, and their latency is
+// measured from the scheduled time. Send times form a Poisson process
+// (exponential inter-arrival times) if poisson_arrivals is set, or are evenly
+// spaced otherwise. Without a target the thread runs closed-loop, issuing the
+// next request as soon as the previous one completes. With count_perf the
+// thread's hardware counters are read during the measured phase.
 inline ClientThreadInfo ClientThread(benchmark::DB *db, benchmark::Workload *wl,
-                        const double exp_len, const int cpu, bool init_wl,
+                        Measurements *measurements,
+                        const double target_ops_per_sec,
+                        bool poisson_arrivals, const int cpu, bool init_wl,
                         bool init_db, bool cleanup_db, bool sleep_on_wait,
-                        CountDownLatch *latch) {
+                        bool count_perf, CountDownLatch *latch) {
 
   using namespace std::chrono;
   if (utils::PinThisThreadToCpu(cpu) != 0) {
     throw std::runtime_error("Error pinning thread to cpu");
   }
-  time_point<system_clock> start = system_clock::now();
-  int64_t nanos_per_op = 1;
-  utils::Timer<int64_t, std::nano> timer;
-  
+  const bool open_loop = target_ops_per_sec > 0;
+  const int64_t nanos_per_op = open_loop ? static_cast<int64_t>(1e9 / target_ops_per_sec) : 1;
+  std::mt19937_64 arrival_gen(std::random_device{}());
+  std::exponential_distribution<double> inter_arrival_nanos(open_loop ? target_ops_per_sec / 1e9 : 1);
+
   // random offset for each thread so that the DB isn't hit by all threads at once
-  std::this_thread::sleep_for(std::chrono::nanoseconds(5000 + std::rand() % nanos_per_op));
-                          
-  int oks = 0;
-  int failed_ops = 0;
-  int overtime_ops = 0;
+  std::this_thread::sleep_for(std::chrono::nanoseconds(5000 + std::rand() % std::max<int64_t>(nanos_per_op, 1)));
+
+  std::unique_ptr<PerfCounters> perf_counters;
+  if (count_perf) {
+    perf_counters = std::make_unique<PerfCounters>();
+  }
+
+  ClientThreadInfo info(cpu);
+  RequestPhase last_phase = RequestPhase::WARMUP;
+  int64_t measure_start = 0;
+  int64_t measure_end = 0;
+  int64_t now = utils::CurrentTimeNanos();
+  int64_t next_send = now;
   while (true) {
-    timer.Start();
-    bool succeeded = wl->DoRequest(*db);
-    oks += succeeded;
-    failed_ops += !succeeded;
-    int64_t time_left = nanos_per_op - timer.End();
-    time_point<system_clock> now = system_clock::now();
-    duration<double> elapsed_time = now - start;
-    if (elapsed_time.count() > exp_len) {
+    int64_t send = open_loop ? std::max(now, next_send) : now;
+    if (measurements->Finished(send)) {
       break;
     }
-    if (time_left < 0) {
-      overtime_ops++; // we're failing to meet our throughput target
-    } else if (sleep_on_wait) {
-      std::this_thread::sleep_for(std::chrono::nanoseconds(time_left));
-    } else { // keep looping until wait is over
-      while (utils::CurrentTimeNanos() < timer.GetStartTime() + time_left);
+    bool overtime = false;
+    if (open_loop) {
+      int64_t time_left = next_send - now;
+      if (time_left < 0) {
+        overtime = true; // we're failing to meet our throughput target
+      } else if (sleep_on_wait) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(time_left));
+      } else { // keep looping until wait is over
+        while (utils::CurrentTimeNanos() < next_send);
+      }
+      measurements->SetIntendedStart(next_send);
+      send = next_send;
+      // the schedule does not slip when we fall behind; late requests are
+      // sent back to back and charged for the time they spent waiting
+      next_send += poisson_arrivals
+        ? static_cast<int64_t>(inter_arrival_nanos(arrival_gen))
+        : nanos_per_op;
     }
+    RequestPhase phase = measurements->BeginRequest(send);
+    if (phase != last_phase && perf_counters) {
+      if (phase == RequestPhase::MEASURE) {
+        perf_counters->Start();
+      } else if (last_phase == RequestPhase::MEASURE) {
+        info.perf = perf_counters->Stop();
+      }
+    }
+    if (phase == RequestPhase::MEASURE && last_phase == RequestPhase::WARMUP) {
+      measure_start = send;
+    }
+    last_phase = phase;
+    bool succeeded = wl->DoRequest(*db);
+    int64_t done = utils::CurrentTimeNanos();
+    if (phase == RequestPhase::MEASURE) {
+      info.completed_ops += succeeded;
+      info.failed_ops += !succeeded;
+      info.overtime_ops += overtime;
+      info.wait_nanos += std::max<int64_t>(send - now, 0);
+      info.latency.Record(std::max<int64_t>(done - send, 0));
+      measure_end = done;
+    }
+    now = done;
+  }
+  measurements->SetIntendedStart(0);
+  if (last_phase == RequestPhase::MEASURE && perf_counters) {
+    info.perf = perf_counters->Stop();
   }
+  info.measured_sec = std::max<int64_t>(measure_end - measure_start, 0) / 1e9;
 
   if (cleanup_db) {
     db->Cleanup();
   }
 
   latch->CountDown();
-  return {oks, overtime_ops, failed_ops};
+  return info;
 }
 
 } // benchmark
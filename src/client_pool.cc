@@ -0,0 +1,156 @@
+#include "client_pool.h"
+
+#include "db_factory.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace benchmark {
+
+ClientPool::ClientPool(utils::Properties *props, Measurements *measurements)
+    : props_(props)
+    , measurements_(measurements)
+    , ready_timeout_sec_(std::stod(props->GetProperty("client.ready_timeout_sec", "30")))
+    , generation_(0)
+    , job_(nullptr)
+    , pending_(0)
+{
+}
+
+ClientPool::~ClientPool() {
+  Resize(0);
+}
+
+int ClientPool::Size() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return static_cast<int>(clients_.size());
+}
+
+void ClientPool::Resize(int num_clients) {
+  std::vector<std::unique_ptr<Client>> stopped;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    while (static_cast<int>(clients_.size()) > num_clients) {
+      clients_.back()->stop = true;
+      stopped.push_back(std::move(clients_.back()));
+      clients_.pop_back();
+    }
+  }
+  start_.notify_all();
+  for (auto &client : stopped) {
+    client->thread.join();
+  }
+
+  std::unique_lock<std::mutex> lock(lock_);
+  size_t first_new = clients_.size();
+  if (static_cast<int>(first_new) >= num_clients) {
+    return;
+  }
+  std::cout << "Connecting " << num_clients - first_new << " new clients" << std::endl;
+  // Connections are opened one at a time, as some client libraries need to
+  // initialize global state on first use; waiting for them to become ready
+  // happens in parallel on the client threads.
+  pending_ = num_clients - static_cast<int>(first_new);
+  for (int i = static_cast<int>(first_new); i < num_clients; ++i) {
+    DB *db = DBFactory::CreateDB(props_, measurements_);
+    if (db == nullptr) {
+      throw std::runtime_error("Unknown database name " + props_->GetProperty("dbname", "test"));
+    }
+    clients_.push_back(std::make_unique<Client>(Client{i, db, std::thread(), generation_, false,
+                                                       ClientThreadInfo(), nullptr}));
+    clients_.back()->thread = std::thread(&ClientPool::Work, this, clients_.back().get());
+  }
+  done_.wait(lock, [this] { return pending_ == 0; });
+  for (size_t i = first_new; i < clients_.size(); ++i) {
+    if (clients_[i]->error) {
+      std::exception_ptr error = clients_[i]->error;
+      lock.unlock();
+      Resize(static_cast<int>(first_new));
+      std::rethrow_exception(error);
+    }
+  }
+  std::cout << "All " << num_clients << " clients are ready" << std::endl;
+}
+
+std::vector<ClientThreadInfo> ClientPool::Run(Job const &job) {
+  std::unique_lock<std::mutex> lock(lock_);
+  job_ = &job;
+  pending_ = static_cast<int>(clients_.size());
+  ++generation_;
+  start_.notify_all();
+  done_.wait(lock, [this] { return pending_ == 0; });
+  job_ = nullptr;
+
+  std::vector<ClientThreadInfo> results;
+  for (auto &client : clients_) {
+    if (client->error) {
+      std::exception_ptr error = client->error;
+      client->error = nullptr;
+      std::rethrow_exception(error);
+    }
+    results.push_back(client->result);
+  }
+  return results;
+}
+
+void ClientPool::Work(Client *client) {
+  std::exception_ptr error;
+  try {
+    WaitUntilReady(client->db);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    client->error = error;
+    if (--pending_ == 0) {
+      done_.notify_all();
+    }
+  }
+
+  while (!error) {
+    std::unique_lock<std::mutex> lock(lock_);
+    start_.wait(lock, [&] { return client->stop || client->generation != generation_; });
+    if (client->stop) {
+      break;
+    }
+    client->generation = generation_;
+    Job const &job = *job_;
+    lock.unlock();
+
+    ClientThreadInfo result;
+    std::exception_ptr job_error;
+    try {
+      result = job(client->index, client->db);
+    } catch (...) {
+      job_error = std::current_exception();
+    }
+
+    lock.lock();
+    client->result = result;
+    client->error = job_error;
+    if (--pending_ == 0) {
+      done_.notify_all();
+    }
+  }
+
+  client->db->Cleanup();
+  delete client->db;
+}
+
+void ClientPool::WaitUntilReady(DB *db) const {
+  const int64_t deadline = utils::CurrentTimeNanos() + static_cast<int64_t>(ready_timeout_sec_ * 1e9);
+  std::chrono::milliseconds backoff(10);
+  while (db->Ping() != Status::kOK) {
+    if (utils::CurrentTimeNanos() > deadline) {
+      throw std::runtime_error("DB connection did not answer a ping within "
+                               + std::to_string(ready_timeout_sec_) + " sec");
+    }
+    std::this_thread::sleep_for(backoff);
+    backoff = std::min(backoff * 2, std::chrono::milliseconds(1000));
+  }
+}
+
+} // benchmark
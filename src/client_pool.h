@@ -0,0 +1,84 @@
+#ifndef CLIENT_POOL_H_
+#define CLIENT_POOL_H_
+
+#include "client_stats.h"
+#include "db.h"
+#include "measurements.h"
+#include "properties.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace benchmark {
+
+///
+/// Client threads and their DB connections, kept alive across experiments.
+/// Between experiments the pool grows or shrinks to the next experiment's
+/// number of clients, so connections are only opened for clients that did not
+/// exist yet. A new connection counts as ready once DB::Ping succeeds, which
+/// replaces waiting a fixed time for connections to form. Run hands the same
+/// job to every client at once, so they all start together.
+///
+/// Properties:
+///   client.ready_timeout_sec  how long a new connection may take to answer
+///                             a ping (default 30)
+///
+class ClientPool {
+ public:
+  // Runs one client's share of an experiment. @param client numbers the
+  // clients from 0.
+  using Job = std::function<ClientThreadInfo(int client, DB *db)>;
+
+  ClientPool(utils::Properties *props, Measurements *measurements);
+  // Stops all clients and closes their connections.
+  ~ClientPool();
+
+  ClientPool(const ClientPool &) = delete;
+  ClientPool &operator=(const ClientPool &) = delete;
+
+  // Stops clients beyond @param num_clients, or connects new ones and waits
+  // until they are ready; throws std::runtime_error if a connection fails.
+  void Resize(int num_clients);
+
+  // Runs @param job on every client and returns their results in client
+  // order once all of them are done. Rethrows the first exception a job
+  // threw.
+  std::vector<ClientThreadInfo> Run(Job const &job);
+
+  int Size();
+
+ private:
+  struct Client {
+    int index;
+    DB *db;
+    std::thread thread;
+    uint64_t generation; // last job taken
+    bool stop;
+    ClientThreadInfo result;
+    std::exception_ptr error;
+  };
+
+  void Work(Client *client);
+  void WaitUntilReady(DB *db) const;
+
+  utils::Properties *const props_;
+  Measurements *const measurements_;
+  const double ready_timeout_sec_;
+  std::mutex lock_; // guards everything below
+  std::condition_variable start_; // a job was posted, or clients should stop
+  std::condition_variable done_; // pending_ dropped to 0
+  std::vector<std::unique_ptr<Client>> clients_;
+  uint64_t generation_; // bumped for every job
+  Job const *job_;
+  int pending_; // clients that have not finished connecting or the current job
+};
+
+} // benchmark
+
+#endif // CLIENT_POOL_H_
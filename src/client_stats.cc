@@ -0,0 +1,124 @@
+#include "client_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace benchmark {
+
+namespace {
+  // p99 of kReportedPercentiles
+  uint64_t P99(LatencySummary const &latency) {
+    auto const *p99 = std::find(std::begin(kReportedPercentiles), std::end(kReportedPercentiles), 99);
+    return latency.percentiles[p99 - std::begin(kReportedPercentiles)];
+  }
+}
+
+ClientThreadInfo::ClientThreadInfo(int cpu)
+    : cpu(cpu)
+    , completed_ops(0)
+    , overtime_ops(0)
+    , failed_ops(0)
+    , wait_nanos(0)
+    , measured_sec(0)
+{
+}
+
+ClientThreadStats::ClientThreadStats(int thread, ClientThreadInfo const &info)
+    : thread(thread)
+    , cpu(info.cpu)
+    , completed_ops(info.completed_ops)
+    , overtime_ops(info.overtime_ops)
+    , failed_ops(info.failed_ops)
+    , throughput(info.measured_sec > 0 ? info.completed_ops / info.measured_sec : 0)
+    , wait_share(info.measured_sec > 0 ? info.wait_nanos / (info.measured_sec * 1e9) : 0)
+    , latency(info.latency)
+{
+}
+
+ClientImbalance::ClientImbalance(std::vector<ClientThreadStats> const &threads)
+    : min_throughput(0)
+    , median_throughput(0)
+    , max_throughput(0)
+    , mean_throughput(0)
+    , throughput_cov(0)
+    , min_p99(0)
+    , max_p99(0)
+{
+  if (threads.empty()) {
+    return;
+  }
+  std::vector<double> throughput;
+  for (ClientThreadStats const &stats : threads) {
+    throughput.push_back(stats.throughput);
+  }
+  std::sort(throughput.begin(), throughput.end());
+  min_throughput = throughput.front();
+  max_throughput = throughput.back();
+  size_t mid = throughput.size() / 2;
+  median_throughput = throughput.size() % 2 == 1 ? throughput[mid]
+                                                 : (throughput[mid - 1] + throughput[mid]) / 2;
+  double sum = 0;
+  for (double value : throughput) {
+    sum += value;
+  }
+  mean_throughput = sum / throughput.size();
+  double squares = 0;
+  for (double value : throughput) {
+    squares += (value - mean_throughput) * (value - mean_throughput);
+  }
+  throughput_cov = mean_throughput > 0 ? std::sqrt(squares / throughput.size()) / mean_throughput : 0;
+
+  bool first = true;
+  for (ClientThreadStats const &stats : threads) {
+    if (stats.latency.count > 0) {
+      uint64_t p99 = P99(stats.latency);
+      min_p99 = first ? p99 : std::min(min_p99, p99);
+      max_p99 = first ? p99 : std::max(max_p99, p99);
+      first = false;
+    }
+    if (stats.throughput < kStragglerThreshold * median_throughput) {
+      stragglers.push_back(stats.thread);
+    }
+  }
+}
+
+std::vector<ClientThreadStats> SummarizeClientThreads(std::vector<ClientThreadInfo> const &threads) {
+  std::vector<ClientThreadStats> stats;
+  for (size_t i = 0; i < threads.size(); ++i) {
+    stats.emplace_back(static_cast<int>(i), threads[i]);
+  }
+  return stats;
+}
+
+void PrintClientThreads(std::ostream &out, std::vector<ClientThreadStats> const &threads,
+                        ClientImbalance const &imbalance) {
+  out << "thread,cpu,completed_ops,failed_ops,overtime_ops,throughput,wait_share,avg_us";
+  for (double percentile : kReportedPercentiles) {
+    out << ",p" << PercentileLabel(percentile) << "_us";
+  }
+  out << std::endl;
+  for (ClientThreadStats const &stats : threads) {
+    out << stats.thread << "," << stats.cpu << "," << stats.completed_ops << "," << stats.failed_ops
+        << "," << stats.overtime_ops << "," << stats.throughput << "," << stats.wait_share
+        << "," << stats.latency.mean / 1000.0;
+    for (uint64_t value : stats.latency.percentiles) {
+      out << "," << value / 1000.0;
+    }
+    out << std::endl;
+  }
+  out << "Client thread imbalance: throughput min=" << imbalance.min_throughput
+      << " median=" << imbalance.median_throughput
+      << " max=" << imbalance.max_throughput
+      << " cov=" << imbalance.throughput_cov
+      << "; p99 min=" << imbalance.min_p99 / 1000.0 << "us max=" << imbalance.max_p99 / 1000.0 << "us"
+      << "; stragglers (below " << ClientImbalance::kStragglerThreshold << " of median):";
+  if (imbalance.stragglers.empty()) {
+    out << " none";
+  }
+  for (int thread : imbalance.stragglers) {
+    out << " " << thread << " (cpu " << threads[thread].cpu << ")";
+  }
+  out << std::endl;
+}
+
+} // benchmark
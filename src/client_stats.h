@@ -0,0 +1,71 @@
+#ifndef CLIENT_STATS_H_
+#define CLIENT_STATS_H_
+
+#include "histogram.h"
+#include "measurements.h"
+#include "perf_counters.h"
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace benchmark {
+
+// What one client thread did after the warmup of an experiment.
+struct ClientThreadInfo {
+  explicit ClientThreadInfo(int cpu = -1);
+
+  int cpu; // the thread is pinned to this CPU
+  uint64_t completed_ops;
+  uint64_t overtime_ops; // requests sent later than scheduled
+  uint64_t failed_ops;
+  uint64_t wait_nanos; // time spent waiting for the next scheduled send
+  double measured_sec;
+  // End-to-end latency of each request, including retries and backoff; from
+  // the scheduled send time in open-loop runs.
+  Histogram latency;
+  PerfCounts perf; // empty unless counting perf events
+};
+
+// Per-thread summary as reported at the end of an experiment.
+struct ClientThreadStats {
+  ClientThreadStats(int thread, ClientThreadInfo const &info);
+
+  int thread;
+  int cpu;
+  uint64_t completed_ops;
+  uint64_t overtime_ops;
+  uint64_t failed_ops;
+  double throughput; // completed requests per second
+  double wait_share; // fraction of the measured time spent waiting to send
+  LatencySummary latency;
+};
+
+// Spread of throughput and tail latency across the client threads. A thread
+// counts as a straggler if its throughput is below kStragglerThreshold of the
+// median, e.g. because its connection landed on a slow node or its CPU is
+// shared with another busy thread.
+struct ClientImbalance {
+  static constexpr double kStragglerThreshold = 0.8;
+
+  explicit ClientImbalance(std::vector<ClientThreadStats> const &threads);
+
+  double min_throughput;
+  double median_throughput;
+  double max_throughput;
+  double mean_throughput;
+  double throughput_cov; // coefficient of variation (stddev / mean)
+  uint64_t min_p99; // nanoseconds
+  uint64_t max_p99;
+  std::vector<int> stragglers; // thread numbers
+};
+
+std::vector<ClientThreadStats> SummarizeClientThreads(std::vector<ClientThreadInfo> const &threads);
+
+// Prints the threads as comma-separated rows, followed by the imbalance.
+void PrintClientThreads(std::ostream &out, std::vector<ClientThreadStats> const &threads,
+                        ClientImbalance const &imbalance);
+
+} // benchmark
+
+#endif // CLIENT_STATS_H_
@@ -25,7 +25,8 @@ namespace benchmark {
     //   KEY_POOL_FACTOR * -n * E[write_txn_size].
     constexpr int KEY_POOL_FACTOR = 3;
 
-    // Defines the number of bytes stored in the value of each object/association.
+    // Defines the number of bytes stored in the value of each object/association,
+    // unless the workload config has object_value_sizes or edge_value_sizes lines.
     constexpr int VALUE_SIZE_BYTES = 150;
 
     // Initial backoff limit for a failed operation or transaction; grows exponentially.
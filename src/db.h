@@ -3,8 +3,10 @@
 
 #include "properties.h"
 
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <iostream>
 
 namespace benchmark {
@@ -75,9 +77,26 @@ class DB {
     std::string value;
   };
 
+  // Key of a single row, stored inline: {id} for objects, {id1, id2, type}
+  // for edges.
+  struct Key {
+    int64_t id1; // the object's id, or the edge's id1
+    int64_t id2; // unused for objects
+    int64_t type; // EdgeType of the edge; unused for objects
+  };
+
+  // Timestamp/value pair to write. The value is not owned; its bytes must
+  // outlive the operation.
+  struct TimestampValueRef {
+    int64_t timestamp;
+    std::string_view value;
+  };
+
+  // Building an operation does not allocate, so that a transaction of many
+  // operations can be generated without touching the heap.
   struct DB_Operation {
 
-    DB_Operation(DataTable tab, std::vector<Field> const & k, TimestampValue const & timeval, Operation op)
+    DB_Operation(DataTable tab, Key const & k, TimestampValueRef timeval, Operation op)
       : table(tab)
       , key(k)
       , time_and_value(timeval)
@@ -86,8 +105,8 @@ class DB {
     }
 
     DataTable table;
-    std::vector<Field> key; // 1 int for objects, 3 (id1, id2, type) for edge
-    TimestampValue time_and_value;
+    Key key;
+    TimestampValueRef time_and_value; // empty value for reads and deletes
     Operation operation;
   };
   
@@ -103,18 +122,23 @@ class DB {
   virtual void Cleanup() { }
 
 
+  /// Checks that this DB can serve requests, e.g. that its connection has
+  /// been established, with a trivial round trip.
+  /// @return Status::kOK once ready.
+  ///
+  virtual Status Ping() { return Status::kOK; }
+
+
   /// Reads a record from the database.
   /// Field/value pairs from the result are stored in a vector.
   ///
   /// @param table DataTable::Edges or DataTable::Objects
-  /// @param key Key being read.
-  ///            This vector will either have 3 elements in the format {{"id1", @id1}, {"id2", @id2}, {"type", @type}}
-  ///            or one element in the format {{"id", @id}} for edges and objects, respectively.
-  ///            All of the parameters (including type) are 64-bit ints.
+  /// @param key Key being read: {id1, id2, type} for edges, or only id1 (the
+  ///            object's id) for objects. All of them are 64-bit ints.
   /// @param buffer A vector of timestamp/value pairs. This function should append one value to this.
   /// @return Zero on success, or a non-zero error code on error/record-miss.
   ///
-  virtual Status Read(DataTable table, const std::vector<Field> & key,
+  virtual Status Read(DataTable table, const Key & key,
                       std::vector<TimestampValue> &buffer) = 0;
 
 
@@ -125,7 +149,7 @@ class DB {
   /// The timestamp/value pairs from these rows should be appended to buffer.
   /// As before, @param table specifies the table being read. Format of @param key
   /// is identical to reads.
-  virtual Status Scan(DataTable table, const std::vector<Field> & key, int n,
+  virtual Status Scan(DataTable table, const Key & key, int n,
                       std::vector<TimestampValue> &buffer) = 0;
 
 
@@ -136,25 +160,25 @@ class DB {
   /// @param value Timestamp/Value pair specifying new value for the row.
   /// @return Zero on success, a non-zero error code on error.
   ///
-  virtual Status Update(DataTable table, const std::vector<Field> &key,
-                        TimestampValue const & value) = 0;
+  virtual Status Update(DataTable table, const Key &key,
+                        TimestampValueRef const & value) = 0;
 
 
   /// Inserts a record in @param table for @param key with @param value.
   /// Argument formatting identical to Update.
-  virtual Status Insert(DataTable table, const std::vector<Field> &key,
-                        TimestampValue const & value) = 0;
+  virtual Status Insert(DataTable table, const Key &key,
+                        TimestampValueRef const & value) = 0;
 
 
   /// Deletes a record from the database.
   ///
   /// @param table The name of the table.
-  /// @param key The key (as a list of fields comprising the unique key) of the record to delete.
+  /// @param key The key of the record to delete, formatted as in the Read method
   /// @param value - key should only be deleted if its associated timestamp is less than value.timestamp
   /// @return Zero on success, a non-zero error code on error.
   ///
-  virtual Status Delete(DataTable table, const std::vector<Field> &key,
-                        TimestampValue const & value) = 0;
+  virtual Status Delete(DataTable table, const Key &key,
+                        TimestampValueRef const & value) = 0;
 
 
   /// Execute a single operation (READ, INSERT, UPDATE, DELETE) TODO: maybe add SCAN here?
@@ -172,7 +196,8 @@ class DB {
 
 
   /// Insert records in @param table for @param keys with @param values
-  /// Each element of @param keys is a key vector, formatted as in the other operations
+  /// Each element of @param keys is a key vector, either {{"id1", @id1}, {"id2", @id2}, {"type", @type}}
+  /// for edges or {{"id", @id}} for objects
   /// @param values is a vector of TimestampValue pairs
   /// Value for the ith key (ith element of @param keys) will be the ith element of @param values
   virtual Status BatchInsert(DataTable table, const std::vector<std::vector<Field>> &keys,
@@ -181,7 +206,7 @@ class DB {
   /// NOTE: The main difference between this method and Scan is that this reads keys, not values.
   /// This method reads the first @n keys (or all of them, whichever is smaller) from @param table
   /// in the OPEN interval ( @param floor_key, @param ceiling_key) and writes them to @param key_buffer
-  /// in sorted order. Key formatting is identical to previous methods.
+  /// in sorted order. Keys are formatted as in BatchInsert.
   ///
   /// @param table DataTable::Edges; this is never called on Objects table
   /// @param floor_key - First key read should be the smallest key strictly greater than this.
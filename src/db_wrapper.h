@@ -15,6 +15,8 @@
 namespace benchmark {
 
 // Wrapper Class around DB; times and logs each Execute and ExecuteTransaction operation.
+// Single-key reads and all invalidations are also timed by their path through the
+// cache (see CachePath); transactions only count cache hits and misses.
 class DBWrapper : public DB {
  public:
   DBWrapper(DB *db, Measurements *measurements) :
@@ -30,25 +32,28 @@ class DBWrapper : public DB {
   void Cleanup() {
     db_->Cleanup();
   }
-  Status Read(DataTable table, const std::vector<Field> &key,
+  Status Ping() {
+    return db_->Ping();
+  }
+  Status Read(DataTable table, const Key &key,
               std::vector<TimestampValue> &buffer) {
     throw std::invalid_argument("DBWrapper Read method should never be called.");
   }
 
-  Status Scan(DataTable table, const std::vector<Field> &key, int n,
+  Status Scan(DataTable table, const Key &key, int n,
               std::vector<TimestampValue> &buffer) {
     throw std::invalid_argument("DBWrapper Scan method should never be called.");
   }
 
-  Status Update(DataTable table, const std::vector<Field> &key, const TimestampValue &value) {
+  Status Update(DataTable table, const Key &key, const TimestampValueRef &value) {
     throw std::invalid_argument("DBWrapper Update method should never be called.");
   }
 
-  Status Insert(DataTable table, const std::vector<Field> &key, const TimestampValue &value) {
+  Status Insert(DataTable table, const Key &key, const TimestampValueRef &value) {
     throw std::invalid_argument("DBWrapper Insert method should never be called.");
   }
 
-  Status Delete(DataTable table, const std::vector<Field> &key, const TimestampValue &value) {
+  Status Delete(DataTable table, const Key &key, const TimestampValueRef &value) {
     throw std::invalid_argument("DBWrapper Delete method should never be called.");
   }
 
@@ -58,23 +63,28 @@ class DBWrapper : public DB {
     timer_.Start();
     Status s;
     if (operation.operation == Operation::READ) {
-      if (memcache_->get(operation, read_buffer)) {
+      if (CacheGet(operation, read_buffer)) {
         measurements_->ReportRead(true);
+        measurements_->ReportCacheLatency(CachePath::HIT, timer_.End());
         s = Status::kOK;
       } else {
         measurements_->ReportRead(false);
-        s = db_->Execute(operation, read_buffer, txn_op);
+        s = DBExecute(operation, read_buffer, txn_op);
         if (s == Status::kOK) {
-          memcache_->put(operation, read_buffer);
+          CachePut(operation, read_buffer);
+          measurements_->ReportCacheLatency(CachePath::MISS, timer_.End());
         }
       }
     } else {
-      s = db_->Execute(operation, read_buffer, txn_op);
-      memcache_->invalidate(operation);
+      s = DBExecute(operation, read_buffer, txn_op);
+      Invalidate(operation);
     }
     uint64_t elapsed = timer_.End();
+    ScopedPhase phase(measurements_, ProfilePhase::RECORD);
     if (s == Status::kOK) {
-      measurements_->Report(operation.operation, elapsed);
+      measurements_->Report(operation.operation, elapsed, PrimaryShard(operation));
+    } else {
+      measurements_->ReportFailure(operation.operation, s, PrimaryShard(operation));
     }
     return s;
   }
@@ -91,7 +101,7 @@ class DBWrapper : public DB {
       std::vector<TimestampValue> rsl_db;
       // TODO: set global write lock to memcache.
       for (size_t i = 0; i < operations.size(); i++) {
-        if (!memcache_->get(operations[i], rsl_cache)) {
+        if (!CacheGet(operations[i], rsl_cache)) {
           // TODO: set "key" write lock to memcache.
           measurements_->ReportRead(false);
           rsl_cache.emplace_back(-1, "");
@@ -102,13 +112,16 @@ class DBWrapper : public DB {
       }
       // TODO: unset global write lock to memcache.
       assert(rsl_cache.size() == operations.size()); // TODO: remove
-      s = db_->ExecuteTransaction(miss_ops, rsl_db, read_only);
+      {
+        ScopedPhase phase(measurements_, ProfilePhase::DB_EXECUTE);
+        s = db_->ExecuteTransaction(miss_ops, rsl_db, read_only);
+      }
       if (s == Status::kOK) {
         size_t db_pos = 0;
         for (size_t i = 0; i < operations.size(); i++) {
           if (rsl_cache[i].timestamp == -1){
             read_buffer.push_back(rsl_db[db_pos]);
-            memcache_->put(operations[i], read_buffer);
+            CachePut(operations[i], read_buffer);
             db_pos++;
           } else {
             read_buffer.push_back(rsl_cache[i]);
@@ -117,21 +130,24 @@ class DBWrapper : public DB {
         }
       }
     } else {
-      s = db_->ExecuteTransaction(operations, read_buffer, read_only);
+      {
+        ScopedPhase phase(measurements_, ProfilePhase::DB_EXECUTE);
+        s = db_->ExecuteTransaction(operations, read_buffer, read_only);
+      }
       for (const DB_Operation& op : operations) {
-        memcache_->invalidate(op);
+        Invalidate(op);
       }
     }
     uint64_t elapsed = timer_.End();
+    ScopedPhase phase(measurements_, ProfilePhase::RECORD);
     assert(!operations.empty());
+    Operation txn_type = read_only ? Operation::READTRANSACTION : Operation::WRITETRANSACTION;
+    // a transaction is attributed to the primary shard of its first operation
     if (s != Status::kOK) {
+      measurements_->ReportFailure(txn_type, s, PrimaryShard(operations[0]));
       return s;
     }
-    if (read_only) {
-      measurements_->Report(Operation::READTRANSACTION, elapsed);
-    } else {
-      measurements_->Report(Operation::WRITETRANSACTION, elapsed);
-    }
+    measurements_->Report(txn_type, elapsed, PrimaryShard(operations[0]), operations.size());
     return s;
   }
 
@@ -152,9 +168,40 @@ class DBWrapper : public DB {
   }
 
  private:
+  // The top 7 bits of a generated key hold its shard (see
+  // TraceGeneratorWorkload::GenerateKey); id1 is the object id or the edge's
+  // id1.
+  static int PrimaryShard(const DB_Operation &operation) {
+    return static_cast<int>(operation.key.id1 >> 57);
+  }
+
+  bool CacheGet(const DB_Operation &operation, std::vector<TimestampValue> &read_buffer) {
+    ScopedPhase phase(measurements_, ProfilePhase::CACHE_GET);
+    return memcache_->get(operation, read_buffer);
+  }
+
+  void CachePut(const DB_Operation &operation, std::vector<TimestampValue> &read_buffer) {
+    ScopedPhase phase(measurements_, ProfilePhase::CACHE_PUT);
+    memcache_->put(operation, read_buffer);
+  }
+
+  Status DBExecute(const DB_Operation &operation, std::vector<TimestampValue> &read_buffer,
+                   bool txn_op) {
+    ScopedPhase phase(measurements_, ProfilePhase::DB_EXECUTE);
+    return db_->Execute(operation, read_buffer, txn_op);
+  }
+
+  void Invalidate(const DB_Operation &operation) {
+    ScopedPhase phase(measurements_, ProfilePhase::CACHE_INVALIDATE);
+    invalidate_timer_.Start();
+    memcache_->invalidate(operation);
+    measurements_->ReportCacheLatency(CachePath::INVALIDATE, invalidate_timer_.End());
+  }
+
   DB *db_;
   Measurements *measurements_;
   utils::Timer<uint64_t, std::nano> timer_;
+  utils::Timer<uint64_t, std::nano> invalidate_timer_;
   MemcachedClient *memcache_;
 };
 
@@ -8,18 +8,23 @@
 namespace benchmark {
   struct ExperimentInfo {
     
-    ExperimentInfo(int threads, double warmup_len, double exp_len)
+    ExperimentInfo(int threads, double warmup_len, double exp_len, double target_throughput = 0)
       : num_threads(threads), warmup_len(warmup_len), exp_len(exp_len)
+      , target_throughput(target_throughput)
     {
     }
 
     int num_threads;
     double warmup_len;
     double exp_len;
+    // Total offered load in ops/sec across all threads; 0 runs closed-loop.
+    double target_throughput;
   };
 
-  // Read experiments.txt file into a vector of ExperimentInfo
-  inline std::vector<ExperimentInfo> LoadExperiments(std::string const & experiment_path) {
+  // Read experiments.txt file into a vector of ExperimentInfo.
+  // Lines without a target throughput column use @param default_target_throughput.
+  inline std::vector<ExperimentInfo> LoadExperiments(std::string const & experiment_path,
+                                                     double default_target_throughput = 0) {
     std::ifstream infile {experiment_path};
     std::vector<ExperimentInfo> loaded_experiments;
     for (std::string line; std::getline(infile, line); ) {
@@ -31,11 +36,15 @@ namespace benchmark {
       int num_threads = 0;
       double warmup_len = 0;
       double exp_len = 0;
-      for (int i = 0; i < 3; ++i) {
+      double target_throughput = default_target_throughput;
+      for (int i = 0; i < 4; ++i) {
         std::string token;
         if (!std::getline(iss, token, ',')) {
+          if (i == 3) {
+            break; // target throughput is optional
+          }
           throw std::invalid_argument("Experiments config file is not formatted correctly; "
-            "each line must be of the format num_threads,warmup_len,exp_len.");
+            "each line must be of the format num_threads,warmup_len,exp_len[,target_throughput].");
         }
         switch (i) {
           case 0:
@@ -47,9 +56,12 @@ namespace benchmark {
           case 2:
             exp_len = std::stod(token);
             break;
+          case 3:
+            target_throughput = std::stod(token);
+            break;
         }
       }
-      loaded_experiments.emplace_back(num_threads, warmup_len, exp_len);
+      loaded_experiments.emplace_back(num_threads, warmup_len, exp_len, target_throughput);
     }
     return loaded_experiments;
   }
@@ -58,7 +70,11 @@ namespace benchmark {
     std::cout << "Inputted experiments:" << std::endl;
     for (auto const & experiment : experiments) {
       std::cout << "Running experiment: " << experiment.num_threads << " threads, " 
-        << experiment.warmup_len << " seconds (warmup), " << experiment.exp_len << " seconds (experiment)" << std::endl;
+        << experiment.warmup_len << " seconds (warmup), " << experiment.exp_len << " seconds (experiment)";
+      if (experiment.target_throughput > 0) {
+        std::cout << ", " << experiment.target_throughput << " ops/sec (target)";
+      }
+      std::cout << std::endl;
     }
   }
 }
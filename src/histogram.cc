@@ -0,0 +1,170 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace benchmark {
+
+HistogramLayout::HistogramLayout(int significant_digits, uint64_t highest_trackable)
+    : significant_digits_(significant_digits)
+    , highest_trackable_(highest_trackable) {
+  if (significant_digits < 1 || significant_digits > 4) {
+    throw std::invalid_argument("Histogram significant digits must be between 1 and 4");
+  }
+  // smallest power of two that can resolve 2 * 10^digits distinct values,
+  // i.e. one unit in the last significant digit at the top of each bucket
+  uint64_t largest_exact = 2 * static_cast<uint64_t>(std::pow(10, significant_digits));
+  sub_bucket_bits_ = 1;
+  while ((1ull << sub_bucket_bits_) < largest_exact) {
+    sub_bucket_bits_++;
+  }
+  sub_bucket_count_ = 1ull << sub_bucket_bits_;
+  highest_trackable_ = std::max(highest_trackable_, sub_bucket_count_);
+  size_ = Index(highest_trackable_) + 1;
+}
+
+uint64_t HistogramLayout::LowestEquivalent(size_t index) const {
+  if (index < sub_bucket_count_) {
+    return index;
+  }
+  size_t half = sub_bucket_count_ >> 1;
+  size_t bucket = index / half - 1;
+  return static_cast<uint64_t>(index - bucket * half) << bucket;
+}
+
+uint64_t HistogramLayout::HighestEquivalent(size_t index) const {
+  if (index < sub_bucket_count_) {
+    return index;
+  }
+  size_t half = sub_bucket_count_ >> 1;
+  size_t bucket = index / half - 1;
+  return (static_cast<uint64_t>(index - bucket * half + 1) << bucket) - 1;
+}
+
+Histogram::Histogram(const HistogramLayout &layout)
+    : layout_(layout), count_(0), sum_(0) {
+}
+
+void Histogram::Record(uint64_t value, uint64_t count) {
+  if (counts_.empty()) {
+    counts_.resize(layout_.Size());
+  }
+  counts_[layout_.Index(value)] += count;
+  count_ += count;
+  sum_ += value * count;
+}
+
+void Histogram::Merge(const Histogram &other) {
+  if (other.count_ == 0) {
+    return;
+  }
+  if (!(layout_ == other.layout_)) {
+    throw std::invalid_argument("Cannot merge histograms with different layouts");
+  }
+  if (counts_.empty()) {
+    counts_.resize(layout_.Size());
+  }
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+}
+
+void Histogram::Subtract(const Histogram &other) {
+  if (other.count_ == 0) {
+    return;
+  }
+  if (!(layout_ == other.layout_) || counts_.empty()) {
+    throw std::invalid_argument("Cannot subtract histogram that is not a prefix of this one");
+  }
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    // counters of a single recorder only grow, but a concurrent snapshot may
+    // observe a bucket slightly ahead of the sum; never wrap around
+    counts_[i] -= std::min(counts_[i], other.counts_[i]);
+  }
+  count_ -= std::min(count_, other.count_);
+  sum_ -= std::min(sum_, other.sum_);
+}
+
+void Histogram::Clear() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  sum_ = 0;
+}
+
+uint64_t Histogram::Min() const {
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    if (counts_[i] > 0) {
+      return layout_.LowestEquivalent(i);
+    }
+  }
+  return 0;
+}
+
+uint64_t Histogram::Max() const {
+  for (size_t i = counts_.size(); i > 0; --i) {
+    if (counts_[i - 1] > 0) {
+      return layout_.HighestEquivalent(i - 1);
+    }
+  }
+  return 0;
+}
+
+uint64_t Histogram::ValueAtPercentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_));
+  target = std::max<uint64_t>(target, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= target) {
+      return layout_.HighestEquivalent(i);
+    }
+  }
+  return Max();
+}
+
+ConcurrentHistogram::ConcurrentHistogram(const HistogramLayout &layout)
+    : layout_(layout), counts_(nullptr), sum_(0) {
+}
+
+ConcurrentHistogram::~ConcurrentHistogram() {
+  delete[] counts_.load();
+}
+
+std::atomic<uint64_t> *ConcurrentHistogram::Allocate() {
+  std::atomic<uint64_t> *counts = new std::atomic<uint64_t>[layout_.Size()];
+  for (size_t i = 0; i < layout_.Size(); ++i) {
+    counts[i].store(0, std::memory_order_relaxed);
+  }
+  counts_.store(counts, std::memory_order_release);
+  return counts;
+}
+
+void ConcurrentHistogram::AddTo(Histogram &hist) const {
+  std::atomic<uint64_t> *counts = counts_.load(std::memory_order_acquire);
+  if (counts == nullptr) {
+    return;
+  }
+  if (!(hist.layout_ == layout_)) {
+    throw std::invalid_argument("Cannot merge histograms with different layouts");
+  }
+  if (hist.counts_.empty()) {
+    hist.counts_.resize(layout_.Size());
+  }
+  uint64_t added = 0;
+  for (size_t i = 0; i < layout_.Size(); ++i) {
+    uint64_t n = counts[i].load(std::memory_order_relaxed);
+    hist.counts_[i] += n;
+    added += n;
+  }
+  hist.count_ += added;
+  hist.sum_ += sum_.load(std::memory_order_relaxed);
+}
+
+} // benchmark
@@ -0,0 +1,129 @@
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace benchmark {
+
+///
+/// Log-linear bucketing in the style of HdrHistogram. Every power of two is
+/// split into the same number of linear sub-buckets, so the relative error of a
+/// recorded value is bounded by the configured number of significant decimal
+/// digits while the memory footprint stays fixed regardless of run length.
+///
+class HistogramLayout {
+ public:
+  /// @param significant_digits number of significant decimal digits to keep (1-4)
+  /// @param highest_trackable largest value tracked exactly; larger values are
+  ///                          clamped into the last bucket
+  HistogramLayout(int significant_digits = 2, uint64_t highest_trackable = 60000000000ull);
+
+  size_t Index(uint64_t value) const {
+    if (value > highest_trackable_) {
+      value = highest_trackable_;
+    }
+    if (value < sub_bucket_count_) {
+      return value;
+    }
+    int bucket = 63 - __builtin_clzll(value) - sub_bucket_bits_ + 1;
+    return (static_cast<size_t>(bucket) << (sub_bucket_bits_ - 1)) + (value >> bucket);
+  }
+
+  uint64_t LowestEquivalent(size_t index) const;
+  uint64_t HighestEquivalent(size_t index) const;
+
+  size_t Size() const { return size_; }
+  int SignificantDigits() const { return significant_digits_; }
+  uint64_t HighestTrackable() const { return highest_trackable_; }
+
+  bool operator==(const HistogramLayout &other) const {
+    return sub_bucket_bits_ == other.sub_bucket_bits_ && highest_trackable_ == other.highest_trackable_;
+  }
+
+ private:
+  int significant_digits_;
+  int sub_bucket_bits_;
+  uint64_t sub_bucket_count_;
+  uint64_t highest_trackable_;
+  size_t size_;
+};
+
+///
+/// Plain histogram used for merged views. Counts are not allocated until the
+/// first value is recorded or merged in, so empty histograms are cheap to copy.
+///
+class Histogram {
+ public:
+  explicit Histogram(const HistogramLayout &layout = HistogramLayout());
+
+  void Record(uint64_t value, uint64_t count = 1);
+  void Merge(const Histogram &other);
+  // Removes the values of @param other, which must be a prefix of this
+  // histogram's history (e.g. an earlier snapshot of the same recorder).
+  void Subtract(const Histogram &other);
+  void Clear();
+
+  uint64_t Count() const { return count_; }
+  uint64_t Sum() const { return sum_; }
+  double Mean() const { return count_ > 0 ? static_cast<double>(sum_) / count_ : 0.0; }
+  uint64_t Min() const;
+  uint64_t Max() const;
+  // Returns the highest value equivalent to the given percentile (0-100).
+  uint64_t ValueAtPercentile(double percentile) const;
+
+  const HistogramLayout &Layout() const { return layout_; }
+
+ private:
+  friend class ConcurrentHistogram;
+
+  HistogramLayout layout_;
+  std::vector<uint64_t> counts_;
+  uint64_t count_;
+  uint64_t sum_;
+};
+
+///
+/// Histogram with exactly one writer and any number of concurrent readers.
+/// Recording takes no locks and issues no atomic read-modify-writes: since only
+/// the owning thread modifies the counters, a relaxed load/store pair is enough,
+/// and readers fold the counters into a Histogram on demand via AddTo.
+///
+class ConcurrentHistogram {
+ public:
+  explicit ConcurrentHistogram(const HistogramLayout &layout);
+  ~ConcurrentHistogram();
+
+  ConcurrentHistogram(const ConcurrentHistogram &) = delete;
+  ConcurrentHistogram &operator=(const ConcurrentHistogram &) = delete;
+
+  void Record(uint64_t value) {
+    std::atomic<uint64_t> *counts = counts_.load(std::memory_order_relaxed);
+    if (counts == nullptr) {
+      counts = Allocate();
+    }
+    Increment(counts[layout_.Index(value)], 1);
+    Increment(sum_, value);
+  }
+
+  // Adds the current contents to @param hist; safe to call from any thread.
+  void AddTo(Histogram &hist) const;
+
+  // Single-writer increment; must only be called from the owning thread.
+  static void Increment(std::atomic<uint64_t> &counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<uint64_t> *Allocate();
+
+  HistogramLayout layout_;
+  std::atomic<std::atomic<uint64_t> *> counts_;
+  std::atomic<uint64_t> sum_;
+};
+
+} // benchmark
+
+#endif // HISTOGRAM_H_
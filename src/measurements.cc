@@ -1,7 +1,7 @@
 #include "measurements.h"
 
+#include <algorithm>
 #include <atomic>
-#include <fstream>
 #include <limits>
 #include <numeric>
 #include <sstream>
@@ -21,107 +21,696 @@ const char *kOperationString[static_cast<int>(Operation::MAXOPTYPE)] {
   "WRITETRANSACTION"
 };
 
-Measurements::Measurements() : count_{}, latency_sum_{}, latency_max_{},
-  read_hit_(0), read_miss_(0) {
-  std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
-  for (int i = 0; i < static_cast<int>(Operation::MAXOPTYPE); ++i) {
-    latencies_[i].reserve(31000000);
+const char *kCachePathString[kNumCachePaths] {
+  "CACHE_HIT",
+  "CACHE_MISS",
+  "CACHE_INVALIDATE"
+};
+
+const char *kProfilePhaseString[kNumProfilePhases] {
+  "SELECT_REQUEST",
+  "GENERATE_REQUEST",
+  "CACHE_GET",
+  "DB_EXECUTE",
+  "CACHE_PUT",
+  "CACHE_INVALIDATE",
+  "RECORD"
+};
+
+const char *kRequestPhaseString[kNumRequestPhases] {
+  "WARMUP",
+  "MEASURE",
+  "COOLDOWN"
+};
+
+const char *kOutcomeString[kNumOutcomes] {
+  "OK",
+  "ERROR",
+  "NOT_FOUND",
+  "CONTENTION_EXHAUSTED"
+};
+
+const char *kTxnSizeBucketString[kNumTxnSizeBuckets] {
+  "1",
+  "2-4",
+  "5-16",
+  "17-64",
+  "65+"
+};
+
+namespace {
+  bool IsWrite(Operation op) {
+    return op == Operation::UPDATE || op == Operation::INSERT || op == Operation::DELETE;
+  }
+
+  HistogramLayout LayoutFromProperties(const utils::Properties &props) {
+    int significant_digits = std::stoi(props.GetProperty("histogram.significant_digits", "2"));
+    double max_latency_sec = std::stod(props.GetProperty("histogram.max_latency_sec", "60"));
+    return HistogramLayout(significant_digits, static_cast<uint64_t>(max_latency_sec * 1e9));
+  }
+
+  // Per-shard histograms are kept at one significant digit: every thread may
+  // touch every shard, and a coarse breakdown is enough to spot hot shards.
+  HistogramLayout ShardLayout(const HistogramLayout &layout) {
+    return HistogramLayout(1, layout.HighestTrackable());
+  }
+
+  ShardStats MakeShardStats(std::string name, std::vector<int> const &shards,
+                            MeasurementsSnapshot const &snapshot, uint64_t total_ops,
+                            double runtime_sec) {
+    Histogram latency(snapshot.shard_latency[0].Layout());
+    uint64_t failed = 0;
+    for (int shard : shards) {
+      latency.Merge(snapshot.shard_latency[shard]);
+      failed += snapshot.shard_failed[shard];
+    }
+    return {
+      std::move(name),
+      static_cast<int>(shards.size()),
+      latency.Count(),
+      total_ops > 0 ? 1.0 * latency.Count() / total_ops : 0.0,
+      runtime_sec > 0 ? latency.Count() / runtime_sec : 0.0,
+      failed,
+      LatencySummary(latency)
+    };
+  }
+
+  uint64_t ShardOps(MeasurementsSnapshot const &snapshot) {
+    uint64_t total = 0;
+    for (Histogram const &hist : snapshot.shard_latency) {
+      total += hist.Count();
+    }
+    return total;
   }
 }
 
-void Measurements::Report(Operation op, uint64_t latency) {
-  count_[static_cast<int>(op)].fetch_add(1, std::memory_order_relaxed);
-  latency_sum_[static_cast<int>(op)].fetch_add(latency, std::memory_order_relaxed);
-  uint64_t prev_min = latency_min_[static_cast<int>(op)].load(std::memory_order_relaxed);
-  while (prev_min > latency
-         && !latency_min_[static_cast<int>(op)].compare_exchange_weak(prev_min, latency, std::memory_order_relaxed));
-  uint64_t prev_max = latency_max_[static_cast<int>(op)].load(std::memory_order_relaxed);
-  while (prev_max < latency
-         && !latency_max_[static_cast<int>(op)].compare_exchange_weak(prev_max, latency, std::memory_order_relaxed));
-  vector_lock.lock();
-  latencies_[static_cast<int>(op)].emplace_back(latency);
-  vector_lock.unlock();
+std::atomic<uint64_t> Measurements::next_id_{1};
+
+MeasurementsSnapshot::MeasurementsSnapshot(const HistogramLayout &layout, bool per_shard)
+    : latency(kNumOperations, Histogram(layout))
+    , uncorrected_latency(kNumOperations, Histogram(layout))
+    , cache_latency(kNumCachePaths, Histogram(layout))
+    , read_txn_size_latency(kNumTxnSizeBuckets, Histogram(layout))
+    , write_txn_size_latency(kNumTxnSizeBuckets, Histogram(layout))
+    , failed(kNumOperations, 0)
+    , contention(kNumOperations, 0)
+    , outcomes(kNumOperations, std::array<uint64_t, kNumOutcomes>{})
+    , retries(kNumOperations, 0)
+    , backoff(kNumOperations, Histogram(layout))
+    , phase_latency(kNumProfilePhases, Histogram(layout))
+    , shard_latency(per_shard ? constants::NUM_SHARDS : 0, Histogram(ShardLayout(layout)))
+    , shard_failed(per_shard ? constants::NUM_SHARDS : 0, 0)
+    , read_hit(0)
+    , read_miss(0) {
 }
 
-std::string Measurements::GetStatusMsg() {
+void MeasurementsSnapshot::Merge(const MeasurementsSnapshot &other) {
+  for (int i = 0; i < kNumOperations; ++i) {
+    latency[i].Merge(other.latency[i]);
+    uncorrected_latency[i].Merge(other.uncorrected_latency[i]);
+    failed[i] += other.failed[i];
+    contention[i] += other.contention[i];
+    for (int j = 0; j < kNumOutcomes; ++j) {
+      outcomes[i][j] += other.outcomes[i][j];
+    }
+    retries[i] += other.retries[i];
+    backoff[i].Merge(other.backoff[i]);
+  }
+  for (int i = 0; i < kNumCachePaths; ++i) {
+    cache_latency[i].Merge(other.cache_latency[i]);
+  }
+  for (int i = 0; i < kNumProfilePhases; ++i) {
+    phase_latency[i].Merge(other.phase_latency[i]);
+  }
+  for (int i = 0; i < kNumTxnSizeBuckets; ++i) {
+    read_txn_size_latency[i].Merge(other.read_txn_size_latency[i]);
+    write_txn_size_latency[i].Merge(other.write_txn_size_latency[i]);
+  }
+  for (size_t i = 0; i < shard_latency.size(); ++i) {
+    shard_latency[i].Merge(other.shard_latency[i]);
+    shard_failed[i] += other.shard_failed[i];
+  }
+  read_hit += other.read_hit;
+  read_miss += other.read_miss;
+}
+
+void MeasurementsSnapshot::Subtract(const MeasurementsSnapshot &other) {
+  for (int i = 0; i < kNumOperations; ++i) {
+    latency[i].Subtract(other.latency[i]);
+    uncorrected_latency[i].Subtract(other.uncorrected_latency[i]);
+    failed[i] -= std::min(failed[i], other.failed[i]);
+    contention[i] -= std::min(contention[i], other.contention[i]);
+    for (int j = 0; j < kNumOutcomes; ++j) {
+      outcomes[i][j] -= std::min(outcomes[i][j], other.outcomes[i][j]);
+    }
+    retries[i] -= std::min(retries[i], other.retries[i]);
+    backoff[i].Subtract(other.backoff[i]);
+  }
+  for (int i = 0; i < kNumCachePaths; ++i) {
+    cache_latency[i].Subtract(other.cache_latency[i]);
+  }
+  for (int i = 0; i < kNumProfilePhases; ++i) {
+    phase_latency[i].Subtract(other.phase_latency[i]);
+  }
+  for (int i = 0; i < kNumTxnSizeBuckets; ++i) {
+    read_txn_size_latency[i].Subtract(other.read_txn_size_latency[i]);
+    write_txn_size_latency[i].Subtract(other.write_txn_size_latency[i]);
+  }
+  for (size_t i = 0; i < shard_latency.size(); ++i) {
+    shard_latency[i].Subtract(other.shard_latency[i]);
+    shard_failed[i] -= std::min(shard_failed[i], other.shard_failed[i]);
+  }
+  read_hit -= std::min(read_hit, other.read_hit);
+  read_miss -= std::min(read_miss, other.read_miss);
+}
+
+uint64_t MeasurementsSnapshot::TotalOps() const {
+  uint64_t total = 0;
+  for (Histogram const &hist : latency) {
+    total += hist.Count();
+  }
+  return total;
+}
+
+uint64_t MeasurementsSnapshot::TotalFailed() const {
+  return std::accumulate(failed.begin(), failed.end(), uint64_t{0});
+}
+
+uint64_t MeasurementsSnapshot::TotalContention() const {
+  return std::accumulate(contention.begin(), contention.end(), uint64_t{0});
+}
+
+uint64_t MeasurementsSnapshot::TotalOutcome(RequestOutcome outcome) const {
+  uint64_t total = 0;
+  for (auto const &by_outcome : outcomes) {
+    total += by_outcome[static_cast<int>(outcome)];
+  }
+  return total;
+}
+
+uint64_t MeasurementsSnapshot::TotalRequests() const {
+  uint64_t total = 0;
+  for (auto const &by_outcome : outcomes) {
+    total += std::accumulate(by_outcome.begin(), by_outcome.end(), uint64_t{0});
+  }
+  return total;
+}
+
+uint64_t MeasurementsSnapshot::TotalRetries() const {
+  return std::accumulate(retries.begin(), retries.end(), uint64_t{0});
+}
+
+double MeasurementsSnapshot::AbortRate() const {
+  uint64_t attempts = TotalRequests() + TotalRetries();
+  return attempts > 0 ? 1.0 * TotalContention() / attempts : 0.0;
+}
+
+Histogram MergeWriteLatency(std::vector<Histogram> const &latency) {
+  Histogram write_latency(latency[0].Layout());
+  for (int i = 0; i < kNumOperations; i++) {
+    if (IsWrite(static_cast<Operation>(i))) {
+      write_latency.Merge(latency[i]);
+    }
+  }
+  return write_latency;
+}
+
+Histogram MeasurementsSnapshot::WriteLatency() const {
+  return MergeWriteLatency(latency);
+}
+
+double MeasurementsSnapshot::CacheHitRate() const {
+  uint64_t lookups = read_hit + read_miss;
+  return lookups > 0 ? 1.0 * read_hit / lookups : 0.0;
+}
+
+LatencySummary::LatencySummary(Histogram const &latency)
+    : count(latency.Count())
+    , mean(latency.Mean())
+    , min(latency.Min())
+    , max(latency.Max()) {
+  for (double percentile : kReportedPercentiles) {
+    percentiles.push_back(latency.ValueAtPercentile(percentile));
+  }
+}
+
+OutcomeStats::OutcomeStats(MeasurementsSnapshot const &snapshot, Operation op)
+    : outcomes(snapshot.outcomes[static_cast<int>(op)])
+    , retries(snapshot.retries[static_cast<int>(op)])
+    , backoff(snapshot.backoff[static_cast<int>(op)]) {
+}
+
+uint64_t OutcomeStats::Requests() const {
+  return std::accumulate(outcomes.begin(), outcomes.end(), uint64_t{0});
+}
+
+ThreadRecorder::ThreadRecorder(const HistogramLayout &layout, bool per_shard)
+    : failed{}, contention{}, outcomes{}, retries{}, read_hit(0), read_miss(0) {
+  if (per_shard) {
+    shard_failed = std::make_unique<std::atomic<uint64_t>[]>(constants::NUM_SHARDS);
+    for (int i = 0; i < constants::NUM_SHARDS; ++i) {
+      shard_latency.push_back(std::make_unique<ConcurrentHistogram>(ShardLayout(layout)));
+      shard_failed[i] = 0;
+    }
+  }
+  for (int i = 0; i < kNumOperations; ++i) {
+    latency[i] = std::make_unique<ConcurrentHistogram>(layout);
+    uncorrected_latency[i] = std::make_unique<ConcurrentHistogram>(layout);
+    backoff[i] = std::make_unique<ConcurrentHistogram>(layout);
+  }
+  for (int i = 0; i < kNumCachePaths; ++i) {
+    cache_latency[i] = std::make_unique<ConcurrentHistogram>(layout);
+  }
+  for (int i = 0; i < kNumProfilePhases; ++i) {
+    phase_latency[i] = std::make_unique<ConcurrentHistogram>(layout);
+  }
+  for (int i = 0; i < kNumTxnSizeBuckets; ++i) {
+    read_txn_size_latency[i] = std::make_unique<ConcurrentHistogram>(layout);
+    write_txn_size_latency[i] = std::make_unique<ConcurrentHistogram>(layout);
+  }
+}
+
+void ThreadRecorder::AddTo(MeasurementsSnapshot &snapshot) const {
+  for (int i = 0; i < kNumOperations; ++i) {
+    latency[i]->AddTo(snapshot.latency[i]);
+    uncorrected_latency[i]->AddTo(snapshot.uncorrected_latency[i]);
+    snapshot.failed[i] += failed[i].load(std::memory_order_relaxed);
+    snapshot.contention[i] += contention[i].load(std::memory_order_relaxed);
+    for (int j = 0; j < kNumOutcomes; ++j) {
+      snapshot.outcomes[i][j] += outcomes[i][j].load(std::memory_order_relaxed);
+    }
+    snapshot.retries[i] += retries[i].load(std::memory_order_relaxed);
+    backoff[i]->AddTo(snapshot.backoff[i]);
+  }
+  for (int i = 0; i < kNumCachePaths; ++i) {
+    cache_latency[i]->AddTo(snapshot.cache_latency[i]);
+  }
+  for (int i = 0; i < kNumProfilePhases; ++i) {
+    phase_latency[i]->AddTo(snapshot.phase_latency[i]);
+  }
+  for (int i = 0; i < kNumTxnSizeBuckets; ++i) {
+    read_txn_size_latency[i]->AddTo(snapshot.read_txn_size_latency[i]);
+    write_txn_size_latency[i]->AddTo(snapshot.write_txn_size_latency[i]);
+  }
+  for (size_t i = 0; i < shard_latency.size(); ++i) {
+    shard_latency[i]->AddTo(snapshot.shard_latency[i]);
+    snapshot.shard_failed[i] += shard_failed[i].load(std::memory_order_relaxed);
+  }
+  snapshot.read_hit += read_hit.load(std::memory_order_relaxed);
+  snapshot.read_miss += read_miss.load(std::memory_order_relaxed);
+}
+
+ThreadMeasurements::ThreadMeasurements(const HistogramLayout &layout, bool per_shard)
+    : owner(std::this_thread::get_id())
+    , measured(layout, per_shard)
+    , unmeasured(layout, per_shard)
+    , measuring(true)
+    , intended_start(0) {
+}
+
+Measurements::Measurements() : Measurements(utils::Properties()) {
+}
+
+Measurements::Measurements(const utils::Properties &props)
+    : id_(next_id_++)
+    , layout_(LayoutFromProperties(props))
+    , per_shard_(props.GetProperty("measurements.per_shard", "false") == "true")
+    , profile_(props.GetProperty("measurements.profile", "false") == "true")
+    , measure_start_(utils::CurrentTimeNanos())
+    , measure_end_(std::numeric_limits<int64_t>::max())
+    , run_end_(std::numeric_limits<int64_t>::max())
+    , experiment_start_(measure_start_.load())
+    , measure_len_(SecondsToNanos(std::numeric_limits<double>::infinity()))
+    , cooldown_len_(0)
+    , interval_start_(layout_, per_shard_)
+    , interval_measured_start_(layout_, per_shard_)
+    , measured_start_(layout_, per_shard_)
+    , interval_start_nanos_(experiment_start_) {
+}
+
+ThreadMeasurements &Measurements::RegisterThread() {
+  std::lock_guard<std::mutex> guard(lock_);
+  std::thread::id self = std::this_thread::get_id();
+  for (auto &thread : threads_) {
+    if (thread->owner == self) {
+      return *thread;
+    }
+  }
+  threads_.push_back(std::make_unique<ThreadMeasurements>(layout_, per_shard_));
+  return *threads_.back();
+}
+
+MeasurementsSnapshot Measurements::Collect(bool all_phases) {
+  MeasurementsSnapshot snapshot(layout_, per_shard_);
+  for (auto const &thread : threads_) {
+    thread->measured.AddTo(snapshot);
+    if (all_phases) {
+      thread->unmeasured.AddTo(snapshot);
+    }
+  }
+  return snapshot;
+}
+
+int64_t Measurements::SecondsToNanos(double sec) {
+  // saturate instead of overflowing for "forever"
+  return sec * 1e9 >= static_cast<double>(std::numeric_limits<int64_t>::max() / 4)
+         ? std::numeric_limits<int64_t>::max() / 4
+         : static_cast<int64_t>(std::max(sec, 0.0) * 1e9);
+}
+
+MeasurementsSnapshot Measurements::GetSnapshot() {
+  std::lock_guard<std::mutex> guard(lock_);
+  MeasurementsSnapshot measured = Collect(false);
+  measured.Subtract(measured_start_);
+  return measured;
+}
+
+namespace {
+  void FormatLatency(std::ostream &msg_stream, const char *name, LatencySummary const &latency) {
+    msg_stream << " [" << name << ":"
+               << " Count=" << latency.count
+               << " Max=" << latency.max / 1000.0
+               << " Min=" << latency.min / 1000.0
+               << " Avg=" << latency.mean / 1000.0;
+    for (size_t i = 0; i < latency.percentiles.size(); ++i) {
+      msg_stream << " P" << PercentileLabel(kReportedPercentiles[i]) << "="
+                 << latency.percentiles[i] / 1000.0;
+    }
+    msg_stream << "]";
+  }
+}
+
+std::vector<ShardStats> ShardBreakdown(MeasurementsSnapshot const &snapshot, double runtime_sec) {
+  std::vector<ShardStats> shards;
+  uint64_t total_ops = ShardOps(snapshot);
+  for (size_t i = 0; i < snapshot.shard_latency.size(); ++i) {
+    if (snapshot.shard_latency[i].Count() > 0 || snapshot.shard_failed[i] > 0) {
+      shards.push_back(MakeShardStats(std::to_string(i), {static_cast<int>(i)}, snapshot,
+                                      total_ops, runtime_sec));
+    }
+  }
+  return shards;
+}
+
+std::vector<ShardStats> HotnessBreakdown(MeasurementsSnapshot const &snapshot, double runtime_sec) {
+  std::vector<ShardStats> buckets;
+  int num_shards = snapshot.shard_latency.size();
+  if (num_shards == 0) {
+    return buckets;
+  }
+  std::vector<int> by_ops(num_shards);
+  std::iota(by_ops.begin(), by_ops.end(), 0);
+  std::stable_sort(by_ops.begin(), by_ops.end(), [&](int a, int b) {
+    return snapshot.shard_latency[a].Count() > snapshot.shard_latency[b].Count();
+  });
+
+  static const std::pair<const char *, double> kBuckets[] = {
+    {"hottest 10%", 0.1}, {"10-25%", 0.25}, {"25-50%", 0.5}, {"coldest 50%", 1.0}
+  };
+  uint64_t total_ops = ShardOps(snapshot);
+  int begin = 0;
+  for (auto const &[name, upper] : kBuckets) {
+    int end = std::max(begin, static_cast<int>(std::lround(upper * num_shards)));
+    if (end > begin) {
+      std::vector<int> shards(by_ops.begin() + begin, by_ops.begin() + end);
+      buckets.push_back(MakeShardStats(name, shards, snapshot, total_ops, runtime_sec));
+    }
+    begin = end;
+  }
+  return buckets;
+}
+
+std::string PercentileLabel(double percentile) {
+  std::ostringstream label;
+  label << percentile;
+  return label.str();
+}
+
+std::string Measurements::FormatStatusMsg(MeasurementsSnapshot const &snapshot) {
+  return FormatStatusMsg(snapshot.latency);
+}
+
+std::string Measurements::FormatStatusMsg(std::vector<Histogram> const &latency) {
   std::ostringstream msg_stream;
   msg_stream.precision(2);
-  uint64_t total_cnt = 0;
   msg_stream << std::fixed << " operations;";
-  uint64_t write_cnt = 0;
-  double write_total_latency = 0, write_min_latency = std::numeric_limits<double>::max(), write_max_latency = 0;
+  uint64_t total_cnt = 0;
   for (int i = 0; i < static_cast<int>(Operation::MAXOPTYPE); i++) {
     Operation op = static_cast<Operation>(i);
-    uint64_t cnt = GetCount(op);
-    if (cnt == 0) {
+    if (latency[i].Count() == 0) {
       continue;
     }
-    double op_max_latency = static_cast<double>(latency_max_[static_cast<int>(op)].load(std::memory_order_relaxed)) / 1000.0;
-    double op_min_latency = static_cast<double>(latency_min_[static_cast<int>(op)].load(std::memory_order_relaxed)) / 1000.0;
-    double op_sum_latency = static_cast<double>(latency_sum_[static_cast<int>(op)].load(std::memory_order_relaxed));
-    msg_stream << " [" << kOperationString[static_cast<int>(op)] << ":"
-               << " Count=" << cnt
-               << " Max=" << op_max_latency
-               << " Min=" << op_min_latency
-               << " Avg="
-               << ((cnt > 0)
-                   ? op_sum_latency / cnt
-                   : 0) / 1000.0
-               << "]";
-    total_cnt += cnt;
-    if (op == Operation::UPDATE || op == Operation::INSERT || op == Operation::DELETE) {
-      write_cnt += cnt;
-      write_total_latency += op_sum_latency;
-      write_max_latency = std::max(write_max_latency, op_max_latency);
-      write_min_latency = std::min(write_min_latency, op_min_latency);
-    }
-  }
-  msg_stream << " [" << "WRITE" << ":"
-               << " Count=" << write_cnt
-               << " Max=" << write_max_latency
-               << " Min=" << write_min_latency
-               << " Avg="
-               << ((write_cnt > 0)
-                   ? write_total_latency / write_cnt
-                   : 0) / 1000.0
-               << "]";
+    FormatLatency(msg_stream, kOperationString[static_cast<int>(op)], LatencySummary(latency[i]));
+    total_cnt += latency[i].Count();
+  }
+  FormatLatency(msg_stream, "WRITE", LatencySummary(MergeWriteLatency(latency)));
   return std::to_string(total_cnt) + msg_stream.str();
 }
 
-// TODO(jchan): This function is deprecated.
-std::string Measurements::WriteLatencies() {
-  auto now = std::chrono::system_clock::now();
-  auto now_ms = std::chrono::time_point_cast<std::chrono::milliseconds>(now);
-  auto value = now_ms.time_since_epoch();
-  long curr_time = value.count();
-  // write latencies of each type to a separate file
-  for (int i = 0; i < static_cast<int>(Operation::MAXOPTYPE); ++i) {
-    std::string filename= "final_results4/" + mapOfOps[i] + "_" + std::to_string(curr_time) + ".txt";
-    std::ofstream outFile(filename);
-    for (const auto &e : latencies_[i]) outFile << e << "\n";
+std::string Measurements::FormatCacheLatency(MeasurementsSnapshot const &snapshot) {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed;
+  for (int i = 0; i < kNumCachePaths; i++) {
+    if (snapshot.cache_latency[i].Count() == 0) {
+      continue;
+    }
+    FormatLatency(msg_stream, kCachePathString[i], LatencySummary(snapshot.cache_latency[i]));
   }
-  return "Latencies written to [operation]_" + std::to_string(curr_time) + ".txt";
+  return msg_stream.str();
 }
 
-void Measurements::Reset() {
-  std::fill(std::begin(count_), std::end(count_), 0);
-  std::fill(std::begin(latency_sum_), std::end(latency_sum_), 0);
-  std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
-  std::fill(std::begin(latency_max_), std::end(latency_max_), 0);
-  vector_lock.lock();
-  for (int i = 0; i < static_cast<int>(Operation::MAXOPTYPE); ++i) {
-    latencies_[i].clear();
+std::string Measurements::FormatOutcomes(MeasurementsSnapshot const &snapshot) {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed;
+  for (int i = 0; i < kNumOperations; i++) {
+    OutcomeStats stats(snapshot, static_cast<Operation>(i));
+    if (stats.Requests() == 0) {
+      continue;
+    }
+    msg_stream << " [" << kOperationString[i] << ":";
+    for (int j = 0; j < kNumOutcomes; j++) {
+      msg_stream << " " << kOutcomeString[j] << "=" << stats.outcomes[j];
+    }
+    msg_stream << " Retries=" << stats.retries
+               << " Retried=" << stats.backoff.count
+               << " BackoffAvg=" << stats.backoff.mean / 1000.0
+               << " BackoffMax=" << stats.backoff.max / 1000.0 << "]";
   }
-  vector_lock.unlock();
+  return msg_stream.str();
 }
 
-uint64_t Measurements::GetTotalNumOps() {
-  uint64_t total_count = 0;
-  for (int i = 0; i < static_cast<int>(Operation::MAXOPTYPE); ++i) {
-    Operation op = static_cast<Operation>(i);
-    total_count += GetCount(op);
+std::string Measurements::FormatProfile(MeasurementsSnapshot const &snapshot) {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed;
+  uint64_t harness_nanos = 0;
+  uint64_t total_nanos = 0;
+  for (int i = 0; i < kNumProfilePhases; i++) {
+    Histogram const &phase = snapshot.phase_latency[i];
+    total_nanos += phase.Sum();
+    if (static_cast<ProfilePhase>(i) != ProfilePhase::DB_EXECUTE) {
+      harness_nanos += phase.Sum();
+    }
+    if (phase.Count() > 0) {
+      FormatLatency(msg_stream, kProfilePhaseString[i], LatencySummary(phase));
+    }
   }
-  return total_count;
+  uint64_t requests = snapshot.TotalRequests();
+  msg_stream << " [HARNESS: PerRequest=" << (requests > 0 ? harness_nanos / 1000.0 / requests : 0.0)
+             << " Share=" << (total_nanos > 0 ? 100.0 * harness_nanos / total_nanos : 0.0) << "%]";
+  return msg_stream.str();
+}
+
+std::string Measurements::FormatTxnSizeLatency(MeasurementsSnapshot const &snapshot) {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed;
+  auto format_type = [&](Operation op, std::vector<Histogram> const &by_size) {
+    for (int i = 0; i < kNumTxnSizeBuckets; i++) {
+      if (by_size[i].Count() == 0) {
+        continue;
+      }
+      std::string name = std::string(kOperationString[static_cast<int>(op)]) + " "
+                         + kTxnSizeBucketString[i] + " ops";
+      FormatLatency(msg_stream, name.c_str(), LatencySummary(by_size[i]));
+    }
+  };
+  format_type(Operation::READTRANSACTION, snapshot.read_txn_size_latency);
+  format_type(Operation::WRITETRANSACTION, snapshot.write_txn_size_latency);
+  return msg_stream.str();
+}
+
+std::string Measurements::FormatInterval(IntervalStats const &interval) {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed << interval.start_sec << "-" << interval.end_sec << " sec"
+             << (interval.warmup ? " (warmup)" : "") << ": "
+             << interval.throughput << " ops/sec;"
+             << " hit rate " << interval.cache_hit_rate << ";"
+             << " failed " << interval.failed << ";"
+             << " contention " << interval.contention << ";"
+             << " " << interval.ops << " operations;";
+  for (int i = 0; i < kNumOperations; i++) {
+    if (interval.latency[i].count == 0) {
+      continue;
+    }
+    FormatLatency(msg_stream, kOperationString[i], interval.latency[i]);
+  }
+  FormatLatency(msg_stream, "WRITE", interval.write_latency);
+  return msg_stream.str();
+}
+
+void Measurements::PrintIntervals(std::ostream &out, std::vector<IntervalStats> const &intervals) {
+  out << "start_sec,end_sec,warmup,ops,throughput,cache_hit_rate,failed,contention";
+  for (int i = 0; i < kNumOperations; ++i) {
+    for (double percentile : kReportedPercentiles) {
+      out << "," << kOperationString[i] << "_p" << PercentileLabel(percentile);
+    }
+  }
+  out << std::endl;
+  for (IntervalStats const &interval : intervals) {
+    out << interval.start_sec << "," << interval.end_sec << "," << interval.warmup << ","
+        << interval.ops << "," << interval.throughput << "," << interval.cache_hit_rate << ","
+        << interval.failed << "," << interval.contention;
+    for (int i = 0; i < kNumOperations; ++i) {
+      for (uint64_t value : interval.latency[i].percentiles) {
+        out << "," << value / 1000.0;
+      }
+    }
+    out << std::endl;
+  }
+}
+
+void Measurements::PrintShards(std::ostream &out, std::vector<ShardStats> const &shards) {
+  out << "shards,num_shards,ops,ops_share,throughput,failed,avg_us";
+  for (double percentile : kReportedPercentiles) {
+    out << ",p" << PercentileLabel(percentile) << "_us";
+  }
+  out << std::endl;
+  for (ShardStats const &stats : shards) {
+    out << stats.name << "," << stats.num_shards << "," << stats.ops << "," << stats.ops_share
+        << "," << stats.throughput << "," << stats.failed << "," << stats.latency.mean / 1000.0;
+    for (uint64_t value : stats.latency.percentiles) {
+      out << "," << value / 1000.0;
+    }
+    out << std::endl;
+  }
+}
+
+std::string Measurements::GetStatusMsg() {
+  return FormatStatusMsg(GetSnapshot());
+}
+
+IntervalStats Measurements::CloseInterval() {
+  std::lock_guard<std::mutex> guard(lock_);
+  int64_t start = interval_start_nanos_;
+  int64_t end = utils::CurrentTimeNanos();
+  MeasurementsSnapshot now = Collect(true);
+  MeasurementsSnapshot measured_now = Collect(false);
+  // Requests are recorded by the phase they were sent in, so the measured
+  // recorders hold exactly the requests between measure_start_ and
+  // measure_end_, and the unmeasured ones the rest.
+  MeasurementsSnapshot measured = measured_now;
+  measured.Subtract(interval_measured_start_);
+  MeasurementsSnapshot all = now;
+  all.Subtract(interval_start_);
+  MeasurementsSnapshot unmeasured = all;
+  unmeasured.Subtract(measured);
+  interval_start_ = std::move(now);
+  interval_measured_start_ = std::move(measured_now);
+  interval_start_nanos_ = end;
+
+  int64_t measure_start = std::clamp(measure_start_.load(), start, end);
+  int64_t measure_end = std::clamp(measure_end_.load(), measure_start, end);
+  IntervalStats const *last = nullptr;
+  if (start < measure_start) {
+    // If the measured phase is shorter than the interval, its cooldown
+    // requests land here too, as they can't be told apart from warmup ones.
+    last = &AddInterval(start, measure_start, true, unmeasured);
+  }
+  if (measure_start < measure_end) {
+    last = &AddInterval(measure_start, measure_end, false, measured);
+  }
+  if (measure_end < end && start >= measure_start) {
+    last = &AddInterval(measure_end, end, false, unmeasured);
+  }
+  if (last == nullptr) { // closed twice at the same time
+    last = &AddInterval(start, end, PhaseAt(end) == RequestPhase::WARMUP, all);
+  }
+  return *last;
+}
+
+IntervalStats const &Measurements::AddInterval(int64_t start, int64_t end, bool warmup,
+                                               MeasurementsSnapshot const &interval) {
+  double length = (end - start) / 1e9;
+  std::vector<LatencySummary> latency;
+  Histogram all_latency(layout_);
+  for (Histogram const &hist : interval.latency) {
+    latency.emplace_back(hist);
+    all_latency.Merge(hist);
+  }
+  intervals_.push_back(IntervalStats {
+    (start - experiment_start_) / 1e9,
+    (end - experiment_start_) / 1e9,
+    warmup,
+    interval.TotalOps(),
+    length > 0 ? interval.TotalOps() / length : 0,
+    interval.CacheHitRate(),
+    interval.TotalFailed(),
+    interval.TotalContention(),
+    std::move(latency),
+    LatencySummary(interval.WriteLatency()),
+    all_latency.ValueAtPercentile(99)
+  });
+  return intervals_.back();
+}
+
+std::vector<IntervalStats> Measurements::GetIntervals() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return intervals_;
+}
+
+void Measurements::Reset(double warmup_sec, double measure_sec, double cooldown_sec) {
+  std::lock_guard<std::mutex> guard(lock_);
+  interval_start_ = Collect(true);
+  interval_measured_start_ = Collect(false);
+  measured_start_ = interval_measured_start_;
+  intervals_.clear();
+  experiment_start_ = utils::CurrentTimeNanos();
+  interval_start_nanos_ = experiment_start_;
+  measure_len_ = SecondsToNanos(measure_sec);
+  cooldown_len_ = SecondsToNanos(cooldown_sec);
+  int64_t measure_start = experiment_start_ + SecondsToNanos(warmup_sec);
+  measure_start_ = measure_start;
+  measure_end_ = measure_start + measure_len_;
+  run_end_ = measure_start + measure_len_ + cooldown_len_;
+}
+
+void Measurements::EndWarmup() {
+  std::lock_guard<std::mutex> guard(lock_);
+  int64_t now = utils::CurrentTimeNanos();
+  if (now >= measure_start_) {
+    return;
+  }
+  measure_start_ = now;
+  measure_end_ = now + measure_len_;
+  run_end_ = now + measure_len_ + cooldown_len_;
+}
+
+double Measurements::WarmupSeconds() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return std::max<int64_t>(measure_start_.load() - experiment_start_, 0) / 1e9;
+}
+
+double Measurements::MeasuredSeconds() const {
+  int64_t end = std::min(utils::CurrentTimeNanos(), measure_end_.load());
+  return std::max<int64_t>(end - measure_start_.load(), 0) / 1e9;
+}
+
+uint64_t Measurements::GetTotalNumOps() {
+  return GetSnapshot().TotalOps();
 }
 
 } // benchmark
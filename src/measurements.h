@@ -1,63 +1,483 @@
 #ifndef MEASUREMENTS_H_
 #define MEASUREMENTS_H_
 
+#include "constants.h"
 #include "db.h"
-#include "workload.h"
+#include "histogram.h"
+#include "properties.h"
+#include "timer.h"
+#include "tsc_clock.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
 
 namespace benchmark {
 
+constexpr int kNumOperations = static_cast<int>(Operation::MAXOPTYPE);
+
+extern const char *kOperationString[kNumOperations];
+
+// Path an operation took through the cache tier in front of the DB.
+enum class CachePath {
+  HIT,        // READ served by memcached
+  MISS,       // READ that missed: cache lookup, DB read and cache fill
+  INVALIDATE, // invalidation of a key after a write
+  MAXCACHEPATH
+};
+
+constexpr int kNumCachePaths = static_cast<int>(CachePath::MAXCACHEPATH);
+
+extern const char *kCachePathString[kNumCachePaths];
+
+// Phases of a request timed by the optional harness self-profiling. All but
+// DB_EXECUTE are spent inside taobench rather than the database.
+enum class ProfilePhase {
+  SELECT_REQUEST,   // drawing the request type
+  GENERATE_REQUEST, // sampling keys and values and building the DB_Operations
+  CACHE_GET,
+  DB_EXECUTE,
+  CACHE_PUT,
+  CACHE_INVALIDATE,
+  RECORD,           // recording measurements
+  MAXPHASE
+};
+
+constexpr int kNumProfilePhases = static_cast<int>(ProfilePhase::MAXPHASE);
+
+extern const char *kProfilePhaseString[kNumProfilePhases];
+
+// Final outcome of a request, after any retries on contention.
+enum class RequestOutcome {
+  OK,
+  ERROR,
+  NOT_FOUND,
+  CONTENTION_EXHAUSTED, // still contended after the maximum number of retries
+  MAXOUTCOME
+};
+
+constexpr int kNumOutcomes = static_cast<int>(RequestOutcome::MAXOUTCOME);
+
+extern const char *kOutcomeString[kNumOutcomes];
+
+inline RequestOutcome OutcomeOf(Status status) {
+  switch (status) {
+    case Status::kOK:
+      return RequestOutcome::OK;
+    case Status::kNotFound:
+      return RequestOutcome::NOT_FOUND;
+    case Status::kContentionError:
+      return RequestOutcome::CONTENTION_EXHAUSTED;
+    default:
+      return RequestOutcome::ERROR;
+  }
+}
+
+// Phase of an experiment a request was sent in. Only requests sent in the
+// MEASURE phase count toward the reported statistics.
+enum class RequestPhase {
+  WARMUP,
+  MEASURE,
+  COOLDOWN, // load is kept up while the last measured requests complete
+  MAXREQUESTPHASE
+};
+
+constexpr int kNumRequestPhases = static_cast<int>(RequestPhase::MAXREQUESTPHASE);
+
+extern const char *kRequestPhaseString[kNumRequestPhases];
+
+// Transactions are also recorded by number of operations, in buckets of
+// 1, 2-4, 5-16, 17-64 and 65+ operations.
+constexpr int kNumTxnSizeBuckets = 5;
+
+extern const char *kTxnSizeBucketString[kNumTxnSizeBuckets];
+
+inline int TxnSizeBucket(size_t num_ops) {
+  return num_ops <= 1 ? 0 : num_ops <= 4 ? 1 : num_ops <= 16 ? 2 : num_ops <= 64 ? 3 : 4;
+}
+
+// Tail latencies reported for every operation type.
+constexpr double kReportedPercentiles[] = {50, 90, 99, 99.9, 99.99};
+
+// Formats a percentile for labels, e.g. 99.9 -> "99.9".
+std::string PercentileLabel(double percentile);
+
+// Aggregate of the INSERT, UPDATE and DELETE entries of a per-operation vector.
+Histogram MergeWriteLatency(std::vector<Histogram> const &latency);
+
+// Merged view of the measurements of every thread.
+struct MeasurementsSnapshot {
+  // @param per_shard whether to hold a breakdown by primary shard
+  explicit MeasurementsSnapshot(const HistogramLayout &layout = HistogramLayout(),
+                                bool per_shard = false);
+
+  void Merge(const MeasurementsSnapshot &other);
+  void Subtract(const MeasurementsSnapshot &other);
+
+  uint64_t TotalOps() const;
+  uint64_t TotalFailed() const;
+  uint64_t TotalContention() const;
+  // Requests of all types that ended with the given outcome.
+  uint64_t TotalOutcome(RequestOutcome outcome) const;
+  uint64_t TotalRequests() const;
+  uint64_t TotalRetries() const;
+  // Fraction of attempts (requests and their retries) that hit contention.
+  double AbortRate() const;
+  double CacheHitRate() const;
+  // Aggregate latency of INSERT, UPDATE and DELETE.
+  Histogram WriteLatency() const;
+
+  std::vector<Histogram> latency; // indexed by Operation
+  // Service time of each operation, without the time it spent queued behind
+  // its intended start. Only recorded in open-loop (target throughput) runs,
+  // where `latency` is measured from the intended start instead.
+  std::vector<Histogram> uncorrected_latency;
+  std::vector<Histogram> cache_latency; // indexed by CachePath
+  // READTRANSACTION and WRITETRANSACTION latency, indexed by TxnSizeBucket.
+  std::vector<Histogram> read_txn_size_latency;
+  std::vector<Histogram> write_txn_size_latency;
+  std::vector<uint64_t> failed; // non-OK results other than contention, indexed by Operation
+  std::vector<uint64_t> contention; // contention errors (each one is retried), indexed by Operation
+  // Per request rather than per attempt; indexed by Operation.
+  std::vector<std::array<uint64_t, kNumOutcomes>> outcomes;
+  std::vector<uint64_t> retries;
+  std::vector<Histogram> backoff; // total backoff time of each retried request
+  std::vector<Histogram> phase_latency; // indexed by ProfilePhase; only recorded when profiling
+  // Latency of all operation types and non-OK results, indexed by primary
+  // shard; empty unless per-shard measurements are enabled.
+  std::vector<Histogram> shard_latency;
+  std::vector<uint64_t> shard_failed;
+  uint64_t read_hit;
+  uint64_t read_miss;
+};
+
+// Compact summary of a latency histogram; latencies are in nanoseconds.
+struct LatencySummary {
+  LatencySummary(Histogram const &latency);
+
+  uint64_t count;
+  double mean;
+  uint64_t min;
+  uint64_t max;
+  std::vector<uint64_t> percentiles; // one per kReportedPercentiles
+};
+
+// Final outcomes of the requests of one operation type.
+struct OutcomeStats {
+  OutcomeStats(MeasurementsSnapshot const &snapshot, Operation op);
+
+  uint64_t Requests() const;
+
+  std::array<uint64_t, kNumOutcomes> outcomes; // indexed by RequestOutcome
+  uint64_t retries;
+  LatencySummary backoff; // total backoff time of each retried request
+};
+
+// Operations on one shard or on a group of shards.
+struct ShardStats {
+  std::string name; // shard number, or hotness bucket such as "hottest 10%"
+  int num_shards;
+  uint64_t ops;
+  double ops_share; // fraction of all operations
+  double throughput;
+  uint64_t failed;
+  LatencySummary latency;
+};
+
+// One entry per shard that saw any operations, in shard order.
+std::vector<ShardStats> ShardBreakdown(MeasurementsSnapshot const &snapshot, double runtime_sec);
+
+// Shards grouped by how many operations they received: the hottest 10%,
+// the next 15%, the next 25% and the coldest 50% of all shards.
+std::vector<ShardStats> HotnessBreakdown(MeasurementsSnapshot const &snapshot, double runtime_sec);
+
+// Statistics for one status interval of an experiment.
+struct IntervalStats {
+  double start_sec; // relative to the start of the experiment
+  double end_sec;
+  bool warmup;
+  uint64_t ops;
+  double throughput;
+  double cache_hit_rate;
+  uint64_t failed;
+  uint64_t contention;
+  std::vector<LatencySummary> latency; // indexed by Operation
+  LatencySummary write_latency; // aggregate of INSERT, UPDATE and DELETE
+  uint64_t p99; // over all operation types
+};
+
+// Measurements recorded by a single thread. Only the owning thread writes,
+// so recording never contends with other client threads.
+struct ThreadRecorder {
+  ThreadRecorder(const HistogramLayout &layout, bool per_shard);
+
+  void AddTo(MeasurementsSnapshot &snapshot) const;
+
+  std::unique_ptr<ConcurrentHistogram> latency[kNumOperations];
+  std::unique_ptr<ConcurrentHistogram> uncorrected_latency[kNumOperations];
+  std::unique_ptr<ConcurrentHistogram> cache_latency[kNumCachePaths];
+  std::unique_ptr<ConcurrentHistogram> read_txn_size_latency[kNumTxnSizeBuckets];
+  std::unique_ptr<ConcurrentHistogram> write_txn_size_latency[kNumTxnSizeBuckets];
+  std::atomic<uint64_t> failed[kNumOperations];
+  std::atomic<uint64_t> contention[kNumOperations];
+  std::atomic<uint64_t> outcomes[kNumOperations][kNumOutcomes];
+  std::atomic<uint64_t> retries[kNumOperations];
+  std::unique_ptr<ConcurrentHistogram> backoff[kNumOperations];
+  std::unique_ptr<ConcurrentHistogram> phase_latency[kNumProfilePhases];
+  std::vector<std::unique_ptr<ConcurrentHistogram>> shard_latency; // empty unless per-shard
+  std::unique_ptr<std::atomic<uint64_t>[]> shard_failed;
+  std::atomic<uint64_t> read_hit;
+  std::atomic<uint64_t> read_miss;
+};
+
+// Recorders of a single thread. Requests sent in the measured phase are kept
+// apart from warmup and cooldown ones, so the phase of each request decides
+// where it is counted without resetting anything shared.
+struct ThreadMeasurements {
+  ThreadMeasurements(const HistogramLayout &layout, bool per_shard);
+
+  ThreadRecorder &Current() {
+    return measuring ? measured : unmeasured;
+  }
+
+  std::thread::id owner;
+  ThreadRecorder measured;
+  ThreadRecorder unmeasured; // warmup and cooldown
+  // owner thread only
+  bool measuring; // phase of the current request; see Measurements::BeginRequest
+  int64_t intended_start; // see Measurements::SetIntendedStart
+};
+
+///
+/// Collects latencies and outcomes from all client threads. Recording goes to
+/// per-thread recorders. Each experiment has a shared epoch that splits it into
+/// warmup, measured and cooldown phases; client threads tag every request with
+/// the phase it was sent in (BeginRequest), and cumulative statistics only
+/// cover requests sent in the measured phase. Independently, the status thread
+/// may periodically close an interval, which turns the growth of all recorders
+/// since the previous interval into an IntervalStats entry of the experiment's
+/// time series.
+///
 class Measurements {
  public:
   Measurements();
-  void Report(Operation op, uint64_t latency);
+  // Reads histogram.significant_digits, histogram.max_latency_sec,
+  // measurements.per_shard and measurements.profile.
+  explicit Measurements(const utils::Properties &props);
+  // @param shard primary shard of the operation, or -1 if unknown; only used
+  //              with per-shard measurements
+  // @param txn_size number of operations of a READTRANSACTION or WRITETRANSACTION
+  void Report(Operation op, uint64_t latency, int shard = -1, size_t txn_size = 0) {
+    ThreadMeasurements &thread = Local();
+    ThreadRecorder &local = thread.Current();
+    if (thread.intended_start > 0) {
+      local.uncorrected_latency[static_cast<int>(op)]->Record(latency);
+      int64_t since_intended = utils::CurrentTimeNanos() - thread.intended_start;
+      latency = std::max<int64_t>(latency, since_intended);
+    }
+    local.latency[static_cast<int>(op)]->Record(latency);
+    if (per_shard_ && shard >= 0 && shard < constants::NUM_SHARDS) {
+      local.shard_latency[shard]->Record(latency);
+    }
+    if (op == Operation::READTRANSACTION) {
+      local.read_txn_size_latency[TxnSizeBucket(txn_size)]->Record(latency);
+    } else if (op == Operation::WRITETRANSACTION) {
+      local.write_txn_size_latency[TxnSizeBucket(txn_size)]->Record(latency);
+    }
+  }
+  // Sets the time (as returned by utils::CurrentTimeNanos) at which the calling
+  // thread's current request was scheduled to be sent. Latencies reported by
+  // this thread are then measured from that time, so requests delayed behind a
+  // stalled one are not omitted from the tail (coordinated omission). Pass 0
+  // for closed-loop requests.
+  void SetIntendedStart(int64_t nanos) {
+    Local().intended_start = nanos;
+  }
+  // Tags the calling thread's next request with the phase of the experiment
+  // it is sent in (at @param send_nanos, as returned by
+  // utils::CurrentTimeNanos) and returns that phase. Threads that never call
+  // this record everything as measured.
+  RequestPhase BeginRequest(int64_t send_nanos) {
+    RequestPhase phase = PhaseAt(send_nanos);
+    Local().measuring = phase == RequestPhase::MEASURE;
+    return phase;
+  }
+  RequestPhase PhaseAt(int64_t nanos) const {
+    if (nanos < measure_start_.load(std::memory_order_relaxed)) {
+      return RequestPhase::WARMUP;
+    }
+    return nanos < measure_end_.load(std::memory_order_relaxed) ? RequestPhase::MEASURE
+                                                                : RequestPhase::COOLDOWN;
+  }
+  // Whether the experiment, including its cooldown, is over at @param nanos.
+  bool Finished(int64_t nanos) const {
+    return nanos >= run_end_.load(std::memory_order_relaxed);
+  }
+  // Records a non-OK result of an operation.
+  void ReportFailure(Operation op, Status status, int shard = -1) {
+    ThreadRecorder &local = Local().Current();
+    if (status == Status::kContentionError) {
+      ConcurrentHistogram::Increment(local.contention[static_cast<int>(op)], 1);
+    } else {
+      ConcurrentHistogram::Increment(local.failed[static_cast<int>(op)], 1);
+    }
+    if (per_shard_ && shard >= 0 && shard < constants::NUM_SHARDS) {
+      ConcurrentHistogram::Increment(local.shard_failed[shard], 1);
+    }
+  }
+  // Records how a request ended after @param retries retries on contention,
+  // which spent @param backoff_nanos sleeping between attempts in total. Backoff
+  // is kept out of the service latencies passed to Report.
+  void ReportOutcome(Operation op, Status status, int retries, uint64_t backoff_nanos) {
+    ThreadRecorder &local = Local().Current();
+    int i = static_cast<int>(op);
+    ConcurrentHistogram::Increment(local.outcomes[i][static_cast<int>(OutcomeOf(status))], 1);
+    if (retries > 0) {
+      ConcurrentHistogram::Increment(local.retries[i], retries);
+      local.backoff[i]->Record(backoff_nanos);
+    }
+  }
+  // Whether request phases are profiled; see ScopedPhase.
+  bool Profiling() const {
+    return profile_;
+  }
+  void ReportPhase(ProfilePhase phase, uint64_t nanos) {
+    Local().Current().phase_latency[static_cast<int>(phase)]->Record(nanos);
+  }
   uint64_t GetCount(Operation op) {
-    return count_[static_cast<int>(op)].load(std::memory_order_relaxed);
+    return GetSnapshot().latency[static_cast<int>(op)].Count();
   }
   double GetLatency(Operation op) {
-    uint64_t cnt = GetCount(op);
-    return cnt > 0
-        ? static_cast<double>(latency_sum_[static_cast<int>(op)].load(std::memory_order_relaxed)) / cnt
-        : 0.0;
+    return GetSnapshot().latency[static_cast<int>(op)].Mean();
   }
+  // Latency summary of the measured phase so far.
   std::string GetStatusMsg();
-  std::string WriteLatencies();
-  void Reset();
+  // Starts a new experiment now: clears the time series and cumulative
+  // statistics and sets up its epoch. Requests sent in the first
+  // @param warmup_sec seconds are warmup, those in the following
+  // @param measure_sec seconds are measured, and the experiment ends
+  // @param cooldown_sec seconds later.
+  void Reset(double warmup_sec = 0,
+             double measure_sec = std::numeric_limits<double>::infinity(),
+             double cooldown_sec = 0);
+  // Ends the warmup now if it is still running; the measured phase keeps its
+  // length.
+  void EndWarmup();
+  // Length of the measured phase so far.
+  double MeasuredSeconds() const;
+  // Time from the start of the experiment to the end of its warmup.
+  double WarmupSeconds();
+  // Closes the current interval, appends it to the time series and returns it.
+  // An interval that spans the start or the end of the measured phase is cut
+  // there into one entry per phase, so that the measured entries add up to
+  // the cumulative statistics; the last of them is returned.
+  IntervalStats CloseInterval();
+  std::vector<IntervalStats> GetIntervals();
   uint64_t GetTotalNumOps();
   void ReportRead(bool hit) {
-    // std::cout << "stat:" << hit << ", hit:" << read_hit_ << ", miss:" << read_miss_ << std::endl;
-    if (hit) {
-      read_hit_ ++;
-    } else {
-      read_miss_ ++;
-    }
+    ThreadRecorder &local = Local().Current();
+    ConcurrentHistogram::Increment(hit ? local.read_hit : local.read_miss, 1);
+  }
+  // Records the time an operation spent on the given path through the cache.
+  void ReportCacheLatency(CachePath path, uint64_t latency) {
+    Local().Current().cache_latency[static_cast<int>(path)]->Record(latency);
   }
   double GetCacheHitRate() {
-    return 1.0 * read_hit_ / (read_hit_ + read_miss_);
+    return GetSnapshot().CacheHitRate();
   }
+  // Cumulative measurements of the requests sent in the measured phase so far.
+  MeasurementsSnapshot GetSnapshot();
+
+  static std::string FormatStatusMsg(MeasurementsSnapshot const &snapshot);
+  static std::string FormatStatusMsg(std::vector<Histogram> const &latency);
+  // Latency breakdown by CachePath, e.g. " [CACHE_HIT: Count=...]".
+  static std::string FormatCacheLatency(MeasurementsSnapshot const &snapshot);
+  // Outcomes, retries and backoff per operation type, e.g.
+  // " [READ: OK=... ERROR=... Retries=... Backoff Avg=...]".
+  static std::string FormatOutcomes(MeasurementsSnapshot const &snapshot);
+  // Cost of each profiled request phase and the share spent in the harness.
+  static std::string FormatProfile(MeasurementsSnapshot const &snapshot);
+  // Transaction latency by size, e.g. " [READTRANSACTION 2-4 ops: Count=...]".
+  static std::string FormatTxnSizeLatency(MeasurementsSnapshot const &snapshot);
+  static std::string FormatInterval(IntervalStats const &interval);
+  // Prints shard statistics as comma-separated rows, one per shard or bucket.
+  static void PrintShards(std::ostream &out, std::vector<ShardStats> const &shards);
+  // Prints the time series as comma-separated rows, one per interval.
+  static void PrintIntervals(std::ostream &out, std::vector<IntervalStats> const &intervals);
+ private:
+  ThreadMeasurements &Local() {
+    thread_local uint64_t cached_id = 0;
+    thread_local ThreadMeasurements *cached = nullptr;
+    if (cached_id != id_) {
+      cached = &RegisterThread();
+      cached_id = id_;
+    }
+    return *cached;
+  }
+  ThreadMeasurements &RegisterThread();
+  // Sum of the measured recorders of all threads, plus the unmeasured ones
+  // if @param all_phases. Caller must hold lock_.
+  MeasurementsSnapshot Collect(bool all_phases);
+  static int64_t SecondsToNanos(double sec);
+  // Appends the requests of @param interval to the time series as the entry
+  // from @param start to @param end nanos. Caller must hold lock_.
+  IntervalStats const &AddInterval(int64_t start, int64_t end, bool warmup,
+                                   MeasurementsSnapshot const &interval);
+
+  static std::atomic<uint64_t> next_id_;
+  const uint64_t id_;
+  const HistogramLayout layout_;
+  const bool per_shard_;
+  const bool profile_;
+  // Experiment epoch in utils::CurrentTimeNanos time; read by client threads.
+  std::atomic<int64_t> measure_start_;
+  std::atomic<int64_t> measure_end_;
+  std::atomic<int64_t> run_end_;
+  std::mutex lock_; // guards everything below
+  int64_t experiment_start_;
+  int64_t measure_len_;
+  int64_t cooldown_len_;
+  std::vector<std::unique_ptr<ThreadMeasurements>> threads_;
+  MeasurementsSnapshot interval_start_; // Collect(true) at the end of the last interval
+  MeasurementsSnapshot interval_measured_start_; // Collect(false) at the end of the last interval
+  MeasurementsSnapshot measured_start_; // Collect(false) at the start of the experiment
+  std::vector<IntervalStats> intervals_;
+  int64_t interval_start_nanos_; // end of the last interval
+};
+
+///
+/// Times the enclosing scope as one phase of a request with the time stamp
+/// counter, if measurements are profiling; otherwise it costs a branch.
+///
+class ScopedPhase {
+ public:
+  ScopedPhase(Measurements *measurements, ProfilePhase phase)
+    : measurements_(measurements != nullptr && measurements->Profiling() ? measurements : nullptr)
+    , phase_(phase)
+    , start_(measurements_ != nullptr ? utils::ReadTicks() : 0) {
+  }
+  ~ScopedPhase() {
+    if (measurements_ != nullptr) {
+      // signed and clamped, as a read on another core or a steady_clock
+      // fallback may come out slightly behind start_
+      int64_t ticks = static_cast<int64_t>(utils::ReadTicks()) - static_cast<int64_t>(start_);
+      measurements_->ReportPhase(phase_, utils::TicksToNanos(std::max<int64_t>(ticks, 0)));
+    }
+  }
+
+  ScopedPhase(const ScopedPhase &) = delete;
+  ScopedPhase &operator=(const ScopedPhase &) = delete;
+
  private:
-  std::atomic<uint32_t> count_[static_cast<int>(Operation::MAXOPTYPE)];
-  std::atomic<uint64_t> latency_sum_[static_cast<int>(Operation::MAXOPTYPE)];
-  std::atomic<uint64_t> latency_min_[static_cast<int>(Operation::MAXOPTYPE)];
-  std::atomic<uint64_t> latency_max_[static_cast<int>(Operation::MAXOPTYPE)];
-  std::mutex vector_lock;
-  std::vector<uint64_t> latencies_[static_cast<int>(Operation::MAXOPTYPE)];
-  std::map<int, std::string> mapOfOps = {
-        {0,"Insert"},
-        {1,"Read"},
-        {2,"Update"},
-        {3,"Scan"},
-        {4,"ReadModiyWrite"},
-        {5,"Delete"},
-        {6,"ReadTxn"},
-        {7,"WriteTxn"},
-        {8,"Max"},
-  };
-  std::atomic<int64_t> read_hit_;
-  std::atomic<int64_t> read_miss_;
+  Measurements *const measurements_;
+  const ProfilePhase phase_;
+  const uint64_t start_;
 };
 
 } // benchmark
@@ -1,4 +1,5 @@
 #include "memcache.h"
+#include <charconv>
 #include <iostream>
 
 namespace benchmark {
@@ -17,7 +18,7 @@ MemcachedClient::~MemcachedClient() {
 
 bool MemcachedClient::get(const DB::DB_Operation &operation, std::vector<DB::TimestampValue> &buffer) {
     assert(operation.operation == Operation::READ);
-    std::string key = fields2Str(operation.key);
+    std::string key = key2Str(operation.table, operation.key);
     std::string rsl = readValue(key);
     if (rsl == "") {
         return false;
@@ -29,25 +30,27 @@ bool MemcachedClient::get(const DB::DB_Operation &operation, std::vector<DB::Tim
 
 bool MemcachedClient::put(const DB::DB_Operation &operation, std::vector<DB::TimestampValue> &buffer) {
     assert(operation.operation == Operation::READ);
-    std::string key = fields2Str(operation.key);
+    std::string key = key2Str(operation.table, operation.key);
     std::string value = timeval2Str(buffer[buffer.size()-1]);
     return storeValue(key, value);
 }
 
 bool MemcachedClient::invalidate(const DB::DB_Operation &operation) {
-    std::string key = fields2Str(operation.key);
+    std::string key = key2Str(operation.table, operation.key);
     return deleteValue(key);
 }
 
-std::string MemcachedClient::fields2Str(std::vector<DB::Field> const & k) {
-    std::ostringstream oss;
-    for (size_t i = 0; i < k.size(); i++) {
-        oss << k[i].value;
-        if (i != k.size()-1) {
-            oss << ",";
-        }
+std::string MemcachedClient::key2Str(DataTable table, DB::Key const & k) {
+    // up to three 64-bit ints of at most 20 characters each, and two commas
+    char buf[3 * 20 + 2];
+    char *end = std::to_chars(buf, buf + sizeof(buf), k.id1).ptr;
+    if (table == DataTable::Edges) {
+        *end++ = ',';
+        end = std::to_chars(end, buf + sizeof(buf), k.id2).ptr;
+        *end++ = ',';
+        end = std::to_chars(end, buf + sizeof(buf), k.type).ptr;
     }
-    return oss.str();
+    return std::string(buf, end);
 }
 
 std::string MemcachedClient::timeval2Str(DB::TimestampValue const & tv) {
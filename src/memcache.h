@@ -21,7 +21,8 @@ public:
     bool invalidate(const DB::DB_Operation &operation);
 
 private:
-    std::string fields2Str(std::vector<DB::Field> const & k);
+    // "id" for objects, "id1,id2,type" for edges
+    std::string key2Str(DataTable table, DB::Key const & k);
     std::string timeval2Str(DB::TimestampValue const & tv);
     DB::TimestampValue str2Timeval(const std::string &str);
 
@@ -0,0 +1,274 @@
+#include "metrics_server.h"
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace benchmark {
+
+namespace {
+  // How often the server thread checks whether it should stop.
+  constexpr int kPollTimeoutMs = 200;
+  // Scrapers send a short GET; anything longer than this is cut off.
+  constexpr size_t kMaxRequestSize = 8192;
+
+  void WriteHeader(std::ostream &out, char const *name, char const *type, char const *help) {
+    out << "# HELP " << name << " " << help << "\n"
+        << "# TYPE " << name << " " << type << "\n";
+  }
+
+  // Latencies are recorded in nanoseconds; Prometheus expects base units.
+  double Seconds(double nanos) {
+    return nanos / 1e9;
+  }
+
+  void WriteSummary(std::ostream &out, char const *name, std::string const &labels,
+                    Histogram const &latency) {
+    for (double percentile : kReportedPercentiles) {
+      out << name << "{" << labels << ",quantile=\"" << percentile / 100 << "\"} "
+          << Seconds(latency.ValueAtPercentile(percentile)) << "\n";
+    }
+    out << name << "_sum{" << labels << "} " << Seconds(latency.Sum()) << "\n"
+        << name << "_count{" << labels << "} " << latency.Count() << "\n";
+  }
+
+  std::string Label(char const *name, std::string const &value) {
+    return std::string(name) + "=\"" + value + "\"";
+  }
+
+  void SendAll(int fd, std::string const &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+      ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+      if (n <= 0) {
+        if (n < 0 && errno == EINTR) {
+          continue;
+        }
+        return; // the scraper went away
+      }
+      sent += n;
+    }
+  }
+
+  std::string Response(char const *status, std::string const &body, bool head) {
+    std::ostringstream out;
+    out << "HTTP/1.1 " << status << "\r\n"
+        << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        << "Content-Length: " << body.size() << "\r\n"
+        << "Connection: close\r\n\r\n";
+    if (!head) {
+      out << body;
+    }
+    return out.str();
+  }
+}
+
+MetricsServer::MetricsServer(Measurements *measurements, std::string const &bind_address, int port)
+    : measurements_(measurements)
+    , listen_fd_(-1)
+    , stop_(false)
+    , experiment_index_(-1)
+    , experiment_(0, 0, 0)
+{
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1) {
+    throw std::invalid_argument("Invalid metrics.bind address '" + bind_address
+                                + "'; expected an IPv4 address");
+  }
+  listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    throw std::runtime_error(std::string("Could not create metrics socket: ") + std::strerror(errno));
+  }
+  int reuse = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0
+      || listen(listen_fd_, 16) != 0) {
+    std::string error = std::strerror(errno);
+    close(listen_fd_);
+    throw std::runtime_error("Could not listen for metrics on " + bind_address + ":"
+                             + std::to_string(port) + ": " + error);
+  }
+  thread_ = std::thread(&MetricsServer::Serve, this);
+  std::cout << "Serving metrics on http://" << bind_address << ":" << port << "/metrics" << std::endl;
+}
+
+MetricsServer::~MetricsServer() {
+  stop_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  close(listen_fd_);
+}
+
+std::unique_ptr<MetricsServer> MetricsServer::Create(utils::Properties const &props,
+                                                     Measurements *measurements) {
+  std::string port = props.GetProperty("metrics.port");
+  if (port.empty()) {
+    return nullptr;
+  }
+  return std::make_unique<MetricsServer>(measurements, props.GetProperty("metrics.bind", "127.0.0.1"),
+                                         std::stoi(port));
+}
+
+void MetricsServer::SetExperiment(ExperimentInfo const &experiment) {
+  std::lock_guard<std::mutex> guard(lock_);
+  ++experiment_index_;
+  experiment_ = experiment;
+}
+
+std::string MetricsServer::Render() {
+  // the same aggregation the status thread reports from
+  MeasurementsSnapshot snapshot = measurements_->GetSnapshot();
+  std::vector<IntervalStats> intervals = measurements_->GetIntervals();
+
+  std::ostringstream out;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    WriteHeader(out, "taobench_experiment_index", "gauge",
+                "Position of the running experiment in this run, starting at 0.");
+    out << "taobench_experiment_index " << experiment_index_ << "\n";
+    WriteHeader(out, "taobench_experiment_threads", "gauge", "Client threads of the running experiment.");
+    out << "taobench_experiment_threads " << experiment_.num_threads << "\n";
+    WriteHeader(out, "taobench_experiment_target_throughput", "gauge",
+                "Offered load of the running experiment in ops/sec; 0 if closed-loop.");
+    out << "taobench_experiment_target_throughput " << experiment_.target_throughput << "\n";
+  }
+  WriteHeader(out, "taobench_warmup", "gauge", "1 while the running experiment is warming up.");
+  out << "taobench_warmup "
+      << (measurements_->PhaseAt(utils::CurrentTimeNanos()) == RequestPhase::WARMUP ? 1 : 0) << "\n";
+
+  // Counters restart with every experiment and at the end of warmup, which
+  // Prometheus treats as a counter reset.
+  WriteHeader(out, "taobench_operations_total", "counter", "Completed operations since the end of warmup.");
+  for (int i = 0; i < kNumOperations; ++i) {
+    out << "taobench_operations_total{" << Label("op", kOperationString[i]) << "} "
+        << snapshot.latency[i].Count() << "\n";
+  }
+  WriteHeader(out, "taobench_failed_operations_total", "counter",
+              "Operations that failed with an error other than contention.");
+  for (int i = 0; i < kNumOperations; ++i) {
+    out << "taobench_failed_operations_total{" << Label("op", kOperationString[i]) << "} "
+        << snapshot.failed[i] << "\n";
+  }
+  WriteHeader(out, "taobench_contention_errors_total", "counter", "Attempts that hit contention.");
+  for (int i = 0; i < kNumOperations; ++i) {
+    out << "taobench_contention_errors_total{" << Label("op", kOperationString[i]) << "} "
+        << snapshot.contention[i] << "\n";
+  }
+  WriteHeader(out, "taobench_requests_total", "counter", "Requests by final outcome after retries.");
+  for (int i = 0; i < kNumOperations; ++i) {
+    for (int j = 0; j < kNumOutcomes; ++j) {
+      out << "taobench_requests_total{" << Label("op", kOperationString[i]) << ","
+          << Label("outcome", kOutcomeString[j]) << "} " << snapshot.outcomes[i][j] << "\n";
+    }
+  }
+  WriteHeader(out, "taobench_retries_total", "counter", "Retries of requests that hit contention.");
+  for (int i = 0; i < kNumOperations; ++i) {
+    out << "taobench_retries_total{" << Label("op", kOperationString[i]) << "} "
+        << snapshot.retries[i] << "\n";
+  }
+  WriteHeader(out, "taobench_cache_reads_total", "counter", "Reads looked up in memcached.");
+  out << "taobench_cache_reads_total{result=\"hit\"} " << snapshot.read_hit << "\n"
+      << "taobench_cache_reads_total{result=\"miss\"} " << snapshot.read_miss << "\n";
+  WriteHeader(out, "taobench_cache_hit_ratio", "gauge", "Cache hit rate since the end of warmup.");
+  out << "taobench_cache_hit_ratio " << snapshot.CacheHitRate() << "\n";
+
+  WriteHeader(out, "taobench_latency_seconds", "summary", "Operation latency since the end of warmup.");
+  for (int i = 0; i < kNumOperations; ++i) {
+    WriteSummary(out, "taobench_latency_seconds", Label("op", kOperationString[i]), snapshot.latency[i]);
+  }
+  WriteSummary(out, "taobench_latency_seconds", Label("op", "WRITE"), snapshot.WriteLatency());
+  WriteHeader(out, "taobench_cache_latency_seconds", "summary",
+              "Latency of single-key operations by path through the cache.");
+  for (int i = 0; i < kNumCachePaths; ++i) {
+    WriteSummary(out, "taobench_cache_latency_seconds", Label("path", kCachePathString[i]),
+                 snapshot.cache_latency[i]);
+  }
+
+  if (!intervals.empty()) {
+    IntervalStats const &last = intervals.back();
+    WriteHeader(out, "taobench_interval_end_seconds", "gauge",
+                "End of the last status interval, relative to the start of the experiment.");
+    out << "taobench_interval_end_seconds " << last.end_sec << "\n";
+    WriteHeader(out, "taobench_interval_throughput", "gauge", "Ops/sec in the last status interval.");
+    out << "taobench_interval_throughput " << last.throughput << "\n";
+    WriteHeader(out, "taobench_interval_cache_hit_ratio", "gauge", "Cache hit rate in the last status interval.");
+    out << "taobench_interval_cache_hit_ratio " << last.cache_hit_rate << "\n";
+    WriteHeader(out, "taobench_interval_latency_seconds", "gauge",
+                "Latency percentiles in the last status interval.");
+    auto write_interval = [&out](std::string const &op, LatencySummary const &latency) {
+      for (size_t j = 0; j < latency.percentiles.size(); ++j) {
+        out << "taobench_interval_latency_seconds{" << Label("op", op) << ",quantile=\""
+            << kReportedPercentiles[j] / 100 << "\"} " << Seconds(latency.percentiles[j]) << "\n";
+      }
+    };
+    for (int i = 0; i < kNumOperations; ++i) {
+      write_interval(kOperationString[i], last.latency[i]);
+    }
+    write_interval("WRITE", last.write_latency);
+  }
+  return out.str();
+}
+
+void MetricsServer::Serve() {
+  while (!stop_) {
+    pollfd pfd {listen_fd_, POLLIN, 0};
+    int ready = poll(&pfd, 1, kPollTimeoutMs);
+    if (ready <= 0 || stop_) {
+      continue;
+    }
+    int fd = accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      continue;
+    }
+    try {
+      HandleConnection(fd);
+    } catch (std::exception const &e) {
+      std::cerr << "Error serving metrics: " << e.what() << std::endl;
+    }
+    close(fd);
+  }
+}
+
+void MetricsServer::HandleConnection(int fd) {
+  // don't let a stalled client hold up the server
+  timeval timeout {1, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  std::string request;
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequestSize) {
+    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+    if (n <= 0) {
+      break;
+    }
+    request.append(buffer, n);
+  }
+
+  std::istringstream request_line(request.substr(0, request.find("\r\n")));
+  std::string method;
+  std::string path;
+  request_line >> method >> path;
+  path = path.substr(0, path.find('?'));
+  bool head = method == "HEAD";
+  if (method != "GET" && !head) {
+    SendAll(fd, Response("405 Method Not Allowed", "Only GET is supported\n", head));
+  } else if (path != "/metrics" && path != "/") {
+    SendAll(fd, Response("404 Not Found", "Metrics are served at /metrics\n", head));
+  } else {
+    SendAll(fd, Response("200 OK", Render(), head));
+  }
+}
+
+} // benchmark
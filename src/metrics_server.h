@@ -0,0 +1,59 @@
+#ifndef METRICS_SERVER_H_
+#define METRICS_SERVER_H_
+
+#include "experiment_loader.h"
+#include "measurements.h"
+#include "properties.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace benchmark {
+
+///
+/// Minimal HTTP endpoint that serves the current measurements in the
+/// Prometheus text exposition format, so long runs can be scraped into
+/// dashboards. GET /metrics (or /) returns cumulative counters and latency
+/// quantiles since the end of warmup, plus the most recently closed status
+/// interval. Requests are served one at a time on a background thread.
+///
+class MetricsServer {
+ public:
+  // Binds @param bind_address:@param port; throws std::runtime_error if the
+  // socket cannot be bound.
+  MetricsServer(Measurements *measurements, std::string const &bind_address, int port);
+  ~MetricsServer();
+
+  MetricsServer(const MetricsServer &) = delete;
+  MetricsServer &operator=(const MetricsServer &) = delete;
+
+  // Returns nullptr unless the metrics.port property is set. metrics.bind
+  // selects the address to listen on (default 127.0.0.1).
+  static std::unique_ptr<MetricsServer> Create(utils::Properties const &props,
+                                               Measurements *measurements);
+
+  // Labels the following measurements with the experiment being run.
+  void SetExperiment(ExperimentInfo const &experiment);
+
+  // Current measurements in the Prometheus text format.
+  std::string Render();
+
+ private:
+  void Serve();
+  void HandleConnection(int fd);
+
+  Measurements *const measurements_;
+  int listen_fd_;
+  std::atomic<bool> stop_;
+  std::mutex lock_; // guards the experiment description below
+  int experiment_index_; // -1 before the first experiment
+  ExperimentInfo experiment_;
+  std::thread thread_;
+};
+
+} // benchmark
+
+#endif // METRICS_SERVER_H_
@@ -1,7 +1,8 @@
 #include "parse_config.h"
 
 namespace {
-  const std::unordered_set<std::string> HAVE_VALS {"write_txn_sizes", "read_txn_sizes"};
+  const std::unordered_set<std::string> HAVE_VALS {"write_txn_sizes", "read_txn_sizes",
+        "object_value_sizes", "edge_value_sizes"};
   const std::unordered_set<std::string> HAVE_TYPES {"edge_types", "read_operation_types",
         "write_operation_types",
         "read_txn_operation_types", "errors", "txn_errors", "operation_predicates", 
@@ -48,7 +49,7 @@ namespace benchmark {
       throw std::invalid_argument("Invalid name read from json: " + this->name);
     }
     weights = parseList<double>(matches.str(3), [] (std::string & s) { return std::stod(s); });
-    distribution = std::discrete_distribution<>(weights.begin(), weights.end());
+    distribution = AliasSampler(weights);
   }
 
   template<class T>
@@ -12,6 +12,8 @@
 #include <sstream>
 #include <cassert>
 
+#include "alias_sampler.h"
+
 namespace benchmark {
   class ConfigParser {
 
@@ -37,7 +39,7 @@ namespace benchmark {
         std::vector<std::string> types;
         std::vector<int> vals;
         std::vector<double> weights;
-        std::discrete_distribution<> distribution;
+        AliasSampler distribution;
       };
 
       std::unordered_map<std::string, LineObject> fields;
@@ -0,0 +1,184 @@
+#include "perf_counters.h"
+
+#include <cstring>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace benchmark {
+
+const char *kPerfEventString[kNumPerfEvents] {
+  "cycles",
+  "instructions",
+  "cache_misses",
+  "context_switches"
+};
+
+namespace {
+#ifdef __linux__
+  // layout of a counter read with kReadFormat
+  struct CounterReading {
+    uint64_t value;
+    uint64_t time_enabled;
+    uint64_t time_running;
+  };
+
+  constexpr uint64_t kReadFormat = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  bool ReadCounter(int fd, CounterReading &reading) {
+    return read(fd, &reading, sizeof(reading)) == sizeof(reading);
+  }
+
+  int OpenCounter(PerfEvent event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.inherit = 0;
+    attr.read_format = kReadFormat;
+    switch (event) {
+      case PerfEvent::CYCLES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+      case PerfEvent::INSTRUCTIONS:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+      case PerfEvent::CACHE_MISSES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+      default:
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+        break;
+    }
+    // count kernel time too if perf_event_paranoid allows it
+    for (int exclude_kernel = 0; exclude_kernel <= 1; ++exclude_kernel) {
+      attr.exclude_kernel = exclude_kernel;
+      attr.exclude_hv = exclude_kernel;
+      int fd = syscall(SYS_perf_event_open, &attr, 0 /* this thread */, -1 /* any cpu */, -1, 0);
+      if (fd >= 0) {
+        return fd;
+      }
+    }
+    return -1;
+  }
+#endif
+}
+
+PerfCounts::PerfCounts() : values{}, valid{}, empty(true) {
+}
+
+PerfCounts &PerfCounts::operator+=(const PerfCounts &other) {
+  if (other.empty) {
+    return *this;
+  }
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    values[i] += other.values[i];
+    valid[i] = (empty || valid[i]) && other.valid[i];
+  }
+  empty = false;
+  return *this;
+}
+
+bool PerfCounts::AnyValid() const {
+  for (bool v : valid) {
+    if (v) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string PerfCounts::FormatPerOp(uint64_t ops) const {
+  std::ostringstream out;
+  out.precision(2);
+  out << std::fixed;
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    out << (i > 0 ? " " : "") << kPerfEventString[i] << "=";
+    if (valid[i] && ops > 0) {
+      out << 1.0 * values[i] / ops;
+    } else {
+      out << "n/a";
+    }
+  }
+  int cycles = static_cast<int>(PerfEvent::CYCLES);
+  int instructions = static_cast<int>(PerfEvent::INSTRUCTIONS);
+  if (valid[cycles] && valid[instructions] && values[cycles] > 0) {
+    out << " ipc=" << 1.0 * values[instructions] / values[cycles];
+  }
+  return out.str();
+}
+
+PerfCounters::PerfCounters() : start_enabled_{}, start_running_{} {
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+#ifdef __linux__
+    fds_[i] = OpenCounter(static_cast<PerfEvent>(i));
+#else
+    fds_[i] = -1;
+#endif
+  }
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif
+}
+
+void PerfCounters::Start() {
+#ifdef __linux__
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    if (fds_[i] < 0) {
+      continue;
+    }
+    ioctl(fds_[i], PERF_EVENT_IOC_RESET, 0);
+    CounterReading reading {};
+    ReadCounter(fds_[i], reading);
+    start_enabled_[i] = reading.time_enabled;
+    start_running_[i] = reading.time_running;
+    ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+  }
+#endif
+}
+
+PerfCounts PerfCounters::Stop() {
+  PerfCounts counts;
+  counts.empty = false;
+#ifdef __linux__
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    if (fds_[i] < 0) {
+      continue;
+    }
+    ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+    CounterReading reading;
+    if (!ReadCounter(fds_[i], reading)) {
+      continue;
+    }
+    uint64_t enabled = reading.time_enabled - start_enabled_[i];
+    uint64_t running = reading.time_running - start_running_[i];
+    if (running == 0) {
+      // never scheduled onto the PMU, e.g. all its counters were taken
+      continue;
+    }
+    counts.values[i] = running < enabled
+                       ? static_cast<uint64_t>(static_cast<double>(reading.value) * enabled / running)
+                       : reading.value;
+    counts.valid[i] = true;
+  }
+#endif
+  return counts;
+}
+
+} // benchmark
@@ -0,0 +1,67 @@
+#ifndef PERF_COUNTERS_H_
+#define PERF_COUNTERS_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace benchmark {
+
+enum class PerfEvent {
+  CYCLES,
+  INSTRUCTIONS,
+  CACHE_MISSES, // last level cache
+  CONTEXT_SWITCHES,
+  MAXPERFEVENT
+};
+
+constexpr int kNumPerfEvents = static_cast<int>(PerfEvent::MAXPERFEVENT);
+
+extern const char *kPerfEventString[kNumPerfEvents];
+
+// Counter values of one or more threads. A counter is only valid if it could
+// be opened on every thread that contributed.
+struct PerfCounts {
+  PerfCounts();
+
+  PerfCounts &operator+=(const PerfCounts &other);
+  bool AnyValid() const;
+  // e.g. "cycles=1234.5 instructions=2345.6 ipc=1.90 ..." per operation
+  std::string FormatPerOp(uint64_t ops) const;
+
+  std::array<uint64_t, kNumPerfEvents> values;
+  std::array<bool, kNumPerfEvents> valid;
+  bool empty; // no thread has contributed yet
+};
+
+///
+/// Hardware and software counters of the calling thread, read through
+/// perf_event_open(2). Counters the kernel refuses to open (no PMU in a VM,
+/// perf_event_paranoid too strict) are left out; on other platforms there are
+/// none. When more counters are open than the PMU has, the kernel multiplexes
+/// them, and each count is scaled up to the time its counter was enabled; a
+/// counter that never got onto the PMU is invalid.
+///
+class PerfCounters {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  // Resets and starts counting.
+  void Start();
+  // Stops counting and returns the counts since Start.
+  PerfCounts Stop();
+
+ private:
+  std::array<int, kNumPerfEvents> fds_;
+  // time_enabled and time_running at Start, which resetting does not clear
+  std::array<uint64_t, kNumPerfEvents> start_enabled_;
+  std::array<uint64_t, kNumPerfEvents> start_running_;
+};
+
+} // benchmark
+
+#endif // PERF_COUNTERS_H_
@@ -0,0 +1,534 @@
+#include "results_writer.h"
+
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace benchmark {
+
+namespace {
+  std::string JsonString(std::string const &str) {
+    std::ostringstream out;
+    out << '"';
+    for (char c : str) {
+      switch (c) {
+        case '"':
+          out << "\\\"";
+          break;
+        case '\\':
+          out << "\\\\";
+          break;
+        case '\n':
+          out << "\\n";
+          break;
+        default:
+          out << c;
+      }
+    }
+    out << '"';
+    return out.str();
+  }
+
+  // JSON has no representation for NaN or infinity.
+  std::string JsonNumber(double value) {
+    if (!std::isfinite(value)) {
+      return "null";
+    }
+    std::ostringstream out;
+    out << value;
+    return out.str();
+  }
+
+  std::string CsvString(std::string const &str) {
+    if (str.find_first_of(",\"\n") == std::string::npos) {
+      return str;
+    }
+    std::string quoted = "\"";
+    for (char c : str) {
+      quoted += c;
+      if (c == '"') {
+        quoted += '"';
+      }
+    }
+    return quoted + "\"";
+  }
+
+  void WriteJsonLatency(std::ostream &out, LatencySummary const &latency) {
+    out << "{\"count\": " << latency.count
+        << ", \"avg_us\": " << JsonNumber(latency.mean / 1000.0)
+        << ", \"min_us\": " << JsonNumber(latency.min / 1000.0)
+        << ", \"max_us\": " << JsonNumber(latency.max / 1000.0);
+    for (size_t i = 0; i < latency.percentiles.size(); ++i) {
+      out << ", \"p" << PercentileLabel(kReportedPercentiles[i]) << "_us\": "
+          << JsonNumber(latency.percentiles[i] / 1000.0);
+    }
+    out << "}";
+  }
+
+  void WriteJsonLatencies(std::ostream &out, std::vector<LatencySummary> const &latency,
+                          LatencySummary const &write_latency) {
+    out << "{";
+    for (int i = 0; i < kNumOperations; ++i) {
+      if (latency[i].count == 0) {
+        continue;
+      }
+      out << JsonString(kOperationString[i]) << ": ";
+      WriteJsonLatency(out, latency[i]);
+      out << ", ";
+    }
+    out << "\"WRITE\": ";
+    WriteJsonLatency(out, write_latency);
+    out << "}";
+  }
+
+  // The count, avg, min, max and percentile columns of @param latency, or
+  // as many empty columns if it is null.
+  void WriteCsvLatencyColumns(std::ostream &out, LatencySummary const *latency) {
+    if (latency == nullptr) {
+      out << std::string(4 + std::size(kReportedPercentiles), ',');
+      return;
+    }
+    out << "," << latency->count << "," << latency->mean / 1000.0 << "," << latency->min / 1000.0
+        << "," << latency->max / 1000.0;
+    for (uint64_t value : latency->percentiles) {
+      out << "," << value / 1000.0;
+    }
+  }
+
+  void WriteCsvLatency(std::ostream &out, std::string const &prefix, char const *op,
+                       LatencySummary const &latency) {
+    out << prefix << "," << op;
+    WriteCsvLatencyColumns(out, &latency);
+    WriteCsvLatencyColumns(out, nullptr);
+    out << "\n";
+  }
+
+  // A row whose backoff columns hold @param backoff, and whose latency
+  // columns are empty.
+  void WriteCsvBackoff(std::ostream &out, std::string const &prefix, char const *op,
+                       LatencySummary const &backoff) {
+    out << prefix << "," << op;
+    WriteCsvLatencyColumns(out, nullptr);
+    WriteCsvLatencyColumns(out, &backoff);
+    out << "\n";
+  }
+
+  void WriteCsvLatencies(std::ostream &out, std::string const &prefix,
+                         std::vector<LatencySummary> const &latency,
+                         LatencySummary const &write_latency) {
+    for (int i = 0; i < kNumOperations; ++i) {
+      if (latency[i].count > 0) {
+        WriteCsvLatency(out, prefix, kOperationString[i], latency[i]);
+      }
+    }
+    WriteCsvLatency(out, prefix, "WRITE", write_latency);
+  }
+
+  // Object keyed by @param names, skipping empty entries; an experiment
+  // without writes has no cache invalidations, for example.
+  void WriteJsonNamedLatencies(std::ostream &out, std::vector<LatencySummary> const &latency,
+                               const char *const names[]) {
+    out << "{";
+    bool first = true;
+    for (size_t i = 0; i < latency.size(); ++i) {
+      if (latency[i].count == 0) {
+        continue;
+      }
+      out << (first ? "" : ", ") << JsonString(names[i]) << ": ";
+      WriteJsonLatency(out, latency[i]);
+      first = false;
+    }
+    out << "}";
+  }
+
+  void WriteJsonTxnSizeLatencies(std::ostream &out, std::vector<LatencySummary> const &by_size) {
+    out << "{";
+    bool first = true;
+    for (int i = 0; i < kNumTxnSizeBuckets; ++i) {
+      if (by_size[i].count == 0) {
+        continue;
+      }
+      out << (first ? "" : ", ") << JsonString(kTxnSizeBucketString[i]) << ": ";
+      WriteJsonLatency(out, by_size[i]);
+      first = false;
+    }
+    out << "}";
+  }
+
+  void WriteCsvTxnSizeLatencies(std::ostream &out, std::string const &prefix, Operation op,
+                                std::vector<LatencySummary> const &by_size) {
+    for (int i = 0; i < kNumTxnSizeBuckets; ++i) {
+      if (by_size[i].count > 0) {
+        std::string name = std::string(kOperationString[static_cast<int>(op)]) + "_"
+                           + kTxnSizeBucketString[i];
+        WriteCsvLatency(out, prefix, name.c_str(), by_size[i]);
+      }
+    }
+  }
+
+  void WriteJsonOutcomes(std::ostream &out, std::vector<OutcomeStats> const &outcomes) {
+    out << "{";
+    bool first = true;
+    for (int i = 0; i < kNumOperations; ++i) {
+      OutcomeStats const &stats = outcomes[i];
+      if (stats.Requests() == 0) {
+        continue;
+      }
+      out << (first ? "" : ", ") << JsonString(kOperationString[i]) << ": {";
+      for (int j = 0; j < kNumOutcomes; ++j) {
+        out << JsonString(kOutcomeString[j]) << ": " << stats.outcomes[j] << ", ";
+      }
+      out << "\"retries\": " << stats.retries << ", \"backoff\": ";
+      WriteJsonLatency(out, stats.backoff);
+      out << "}";
+      first = false;
+    }
+    out << "}";
+  }
+
+  void WriteJsonShards(std::ostream &out, std::vector<ShardStats> const &shards) {
+    out << "[";
+    for (size_t i = 0; i < shards.size(); ++i) {
+      ShardStats const &stats = shards[i];
+      out << (i > 0 ? ",\n" : "\n")
+          << "     {\"name\": " << JsonString(stats.name)
+          << ", \"num_shards\": " << stats.num_shards
+          << ", \"ops\": " << stats.ops
+          << ", \"ops_share\": " << JsonNumber(stats.ops_share)
+          << ", \"throughput\": " << JsonNumber(stats.throughput)
+          << ", \"failed\": " << stats.failed
+          << ", \"latency\": ";
+      WriteJsonLatency(out, stats.latency);
+      out << "}";
+    }
+    out << "]";
+  }
+
+  void WriteJsonClientThreads(std::ostream &out, std::vector<ClientThreadStats> const &threads,
+                              ClientImbalance const &imbalance) {
+    out << "[";
+    for (size_t i = 0; i < threads.size(); ++i) {
+      ClientThreadStats const &stats = threads[i];
+      out << (i > 0 ? ",\n" : "\n")
+          << "     {\"thread\": " << stats.thread
+          << ", \"cpu\": " << stats.cpu
+          << ", \"completed_ops\": " << stats.completed_ops
+          << ", \"failed_ops\": " << stats.failed_ops
+          << ", \"overtime_ops\": " << stats.overtime_ops
+          << ", \"throughput\": " << JsonNumber(stats.throughput)
+          << ", \"wait_share\": " << JsonNumber(stats.wait_share)
+          << ", \"latency\": ";
+      WriteJsonLatency(out, stats.latency);
+      out << "}";
+    }
+    out << "],\n   \"client_imbalance\": {\"min_throughput\": " << JsonNumber(imbalance.min_throughput)
+        << ", \"median_throughput\": " << JsonNumber(imbalance.median_throughput)
+        << ", \"max_throughput\": " << JsonNumber(imbalance.max_throughput)
+        << ", \"mean_throughput\": " << JsonNumber(imbalance.mean_throughput)
+        << ", \"throughput_cov\": " << JsonNumber(imbalance.throughput_cov)
+        << ", \"min_p99_us\": " << JsonNumber(imbalance.min_p99 / 1000.0)
+        << ", \"max_p99_us\": " << JsonNumber(imbalance.max_p99 / 1000.0)
+        << ", \"stragglers\": [";
+    for (size_t i = 0; i < imbalance.stragglers.size(); ++i) {
+      out << (i > 0 ? ", " : "") << imbalance.stragglers[i];
+    }
+    out << "]}";
+  }
+
+  bool HasUncorrected(MeasurementsSnapshot const &snapshot) {
+    for (Histogram const &hist : snapshot.uncorrected_latency) {
+      if (hist.Count() > 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+}
+
+ExperimentResult::ExperimentResult(ExperimentInfo const &info, utils::Properties const &props,
+                                   MeasurementsSnapshot const &snapshot)
+    : experiment(info)
+    , db_name(props.GetProperty("dbname", "test"))
+    , config_path(props.GetProperty("config_path"))
+    , runtime_sec(0)
+    , measured_runtime_sec(0)
+    , warmup_sec(0)
+    , completed_ops(snapshot.TotalOps())
+    , throughput(0)
+    , failed_ops(0)
+    , overtime_ops(0)
+    , contention(snapshot.TotalContention())
+    , goodput(0)
+    , attempt_throughput(0)
+    , abort_rate(snapshot.AbortRate())
+    , cache_hit_rate(snapshot.CacheHitRate())
+    , write_latency(snapshot.WriteLatency())
+    , uncorrected_write_latency(MergeWriteLatency(snapshot.uncorrected_latency))
+    , perf_ops(0)
+    , client_imbalance({})
+{
+  for (Histogram const &hist : snapshot.latency) {
+    latency.emplace_back(hist);
+  }
+  for (int i = 0; i < kNumOperations; ++i) {
+    outcomes.emplace_back(snapshot, static_cast<Operation>(i));
+  }
+  for (Histogram const &hist : snapshot.cache_latency) {
+    cache_latency.emplace_back(hist);
+  }
+  if (props.GetProperty("measurements.profile", "false") == "true") {
+    for (Histogram const &hist : snapshot.phase_latency) {
+      phase_latency.emplace_back(hist);
+    }
+  }
+  for (int i = 0; i < kNumTxnSizeBuckets; ++i) {
+    read_txn_size_latency.emplace_back(snapshot.read_txn_size_latency[i]);
+    write_txn_size_latency.emplace_back(snapshot.write_txn_size_latency[i]);
+  }
+  if (HasUncorrected(snapshot)) {
+    for (Histogram const &hist : snapshot.uncorrected_latency) {
+      uncorrected_latency.emplace_back(hist);
+    }
+  }
+}
+
+ResultsWriter::ResultsWriter(std::string const &path, Format format)
+    : path_(path), format_(format)
+{
+}
+
+std::unique_ptr<ResultsWriter> ResultsWriter::Create(utils::Properties const &props) {
+  std::string path = props.GetProperty("results.path");
+  if (path.empty()) {
+    return nullptr;
+  }
+  std::string format = props.GetProperty("results.format");
+  if (format.empty()) {
+    // only a dot in the file name starts an extension, not one in a directory
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.find_last_of('.');
+    bool has_extension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+    format = has_extension ? path.substr(dot + 1) : "json";
+  }
+  if (format == "json") {
+    return std::make_unique<ResultsWriter>(path, Format::kJson);
+  } else if (format == "csv") {
+    return std::make_unique<ResultsWriter>(path, Format::kCsv);
+  }
+  throw std::invalid_argument("Unknown results format '" + format + "'; expected json or csv");
+}
+
+void ResultsWriter::Add(ExperimentResult result) {
+  results_.push_back(std::move(result));
+  std::ofstream out(path_, std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("Could not open results file " + path_);
+  }
+  if (format_ == Format::kJson) {
+    WriteJson(out);
+  } else {
+    WriteCsv(out);
+  }
+}
+
+void ResultsWriter::WriteJson(std::ostream &out) const {
+  out << "{\"experiments\": [";
+  for (size_t e = 0; e < results_.size(); ++e) {
+    ExperimentResult const &result = results_[e];
+    out << (e > 0 ? ",\n" : "\n")
+        << "  {\"num_threads\": " << result.experiment.num_threads
+        << ", \"warmup_len\": " << JsonNumber(result.experiment.warmup_len)
+        << ", \"exp_len\": " << JsonNumber(result.experiment.exp_len)
+        << ", \"db\": " << JsonString(result.db_name)
+        << ", \"config_path\": " << JsonString(result.config_path)
+        << ", \"target_throughput\": " << JsonNumber(result.experiment.target_throughput)
+        << ",\n   \"runtime_sec\": " << JsonNumber(result.runtime_sec)
+        << ", \"measured_runtime_sec\": " << JsonNumber(result.measured_runtime_sec)
+        << ", \"warmup_sec\": " << JsonNumber(result.warmup_sec)
+        << ", \"completed_ops\": " << result.completed_ops
+        << ", \"throughput\": " << JsonNumber(result.throughput)
+        << ", \"failed_ops\": " << result.failed_ops
+        << ", \"overtime_ops\": " << result.overtime_ops
+        << ", \"contention\": " << result.contention
+        << ", \"goodput\": " << JsonNumber(result.goodput)
+        << ", \"attempt_throughput\": " << JsonNumber(result.attempt_throughput)
+        << ", \"abort_rate\": " << JsonNumber(result.abort_rate)
+        << ", \"cache_hit_rate\": " << JsonNumber(result.cache_hit_rate)
+        << ",\n   \"latency\": ";
+    WriteJsonLatencies(out, result.latency, result.write_latency);
+    if (!result.uncorrected_latency.empty()) {
+      out << ",\n   \"uncorrected_latency\": ";
+      WriteJsonLatencies(out, result.uncorrected_latency, result.uncorrected_write_latency);
+    }
+    if (!result.perf.empty) {
+      out << ",\n   \"perf\": {\"requests\": " << result.perf_ops;
+      for (int i = 0; i < kNumPerfEvents; ++i) {
+        out << ", " << JsonString(kPerfEventString[i]) << ": ";
+        if (result.perf.valid[i]) {
+          out << result.perf.values[i];
+        } else {
+          out << "null";
+        }
+      }
+      out << "}";
+    }
+    out << ",\n   \"outcomes\": ";
+    WriteJsonOutcomes(out, result.outcomes);
+    out << ",\n   \"cache_latency\": ";
+    WriteJsonNamedLatencies(out, result.cache_latency, kCachePathString);
+    if (!result.phase_latency.empty()) {
+      out << ",\n   \"profile\": ";
+      WriteJsonNamedLatencies(out, result.phase_latency, kProfilePhaseString);
+    }
+    out << ",\n   \"txn_size_latency\": {\"READTRANSACTION\": ";
+    WriteJsonTxnSizeLatencies(out, result.read_txn_size_latency);
+    out << ", \"WRITETRANSACTION\": ";
+    WriteJsonTxnSizeLatencies(out, result.write_txn_size_latency);
+    out << "}";
+    out << ",\n   \"client_threads\": ";
+    WriteJsonClientThreads(out, result.client_threads, result.client_imbalance);
+    if (!result.shards.empty()) {
+      out << ",\n   \"shards\": ";
+      WriteJsonShards(out, result.shards);
+      out << ",\n   \"hotness_buckets\": ";
+      WriteJsonShards(out, result.hotness_buckets);
+    }
+    out << ",\n   \"intervals\": [";
+    for (size_t i = 0; i < result.intervals.size(); ++i) {
+      IntervalStats const &interval = result.intervals[i];
+      out << (i > 0 ? ",\n" : "\n")
+          << "     {\"start_sec\": " << JsonNumber(interval.start_sec)
+          << ", \"end_sec\": " << JsonNumber(interval.end_sec)
+          << ", \"warmup\": " << (interval.warmup ? "true" : "false")
+          << ", \"ops\": " << interval.ops
+          << ", \"throughput\": " << JsonNumber(interval.throughput)
+          << ", \"cache_hit_rate\": " << JsonNumber(interval.cache_hit_rate)
+          << ", \"failed\": " << interval.failed
+          << ", \"contention\": " << interval.contention
+          << ", \"latency\": ";
+      WriteJsonLatencies(out, interval.latency, interval.write_latency);
+      out << "}";
+    }
+    out << "]}";
+  }
+  out << "\n]}\n";
+}
+
+// One row per (experiment, scope, operation): scope "total" covers the whole
+// measured period, scope "interval" one status interval. Open-loop runs add
+// scope "total_uncorrected" with service times that exclude queueing delay.
+// Cache tier latencies are "total" rows with operation CACHE_HIT, CACHE_MISS
+// or CACHE_INVALIDATE, profiled request phases are "total" rows with operation
+// e.g. PHASE_DB_EXECUTE, and transaction latencies by size are "total" rows
+// with operation e.g. READTRANSACTION_5-16. Scope "retries" has one row per
+// operation type with its requests in the ops column, and the only rows with
+// unsuccessful requests, retries and the backoff time of retried requests.
+// With
+// per-shard measurements, scopes "shard" and "hotness" hold one row per shard
+// or hotness bucket, named in the operation column. Scope "client" holds one
+// row per client thread with its requests, named "thread <n>", and the share
+// of time it spent waiting to send.
+void ResultsWriter::WriteCsv(std::ostream &out) const {
+  out << "experiment,num_threads,warmup_len,exp_len,target_throughput,db,config_path,scope,start_sec,end_sec,"
+         "warmup,ops,throughput,cache_hit_rate,failed,contention,goodput,unsuccessful,retries,"
+         "overtime,wait_share,operation,count,avg_us,min_us,max_us";
+  for (double percentile : kReportedPercentiles) {
+    out << ",p" << PercentileLabel(percentile) << "_us";
+  }
+  out << ",backoff_count,backoff_avg_us,backoff_min_us,backoff_max_us";
+  for (double percentile : kReportedPercentiles) {
+    out << ",backoff_p" << PercentileLabel(percentile) << "_us";
+  }
+  out << "\n";
+  for (size_t e = 0; e < results_.size(); ++e) {
+    ExperimentResult const &result = results_[e];
+    std::ostringstream config;
+    config << e << "," << result.experiment.num_threads << "," << result.experiment.warmup_len
+           << "," << result.experiment.exp_len << "," << result.experiment.target_throughput
+           << "," << CsvString(result.db_name)
+           << "," << CsvString(result.config_path);
+    // start_sec and end_sec of the measured phase, which excludes the warmup
+    // and any cooldown
+    std::ostringstream measured;
+    measured << result.warmup_sec << "," << result.warmup_sec + result.measured_runtime_sec;
+    std::string const measured_window = measured.str();
+
+    auto total_prefix = [&](char const *scope) {
+      std::ostringstream total;
+      total << config.str() << "," << scope << "," << measured_window
+            << ",0," << result.completed_ops << "," << result.throughput
+            << "," << result.cache_hit_rate << "," << result.failed_ops << "," << result.contention
+            << "," << result.goodput << ",,," << result.overtime_ops << ",";
+      return total.str();
+    };
+    WriteCsvLatencies(out, total_prefix("total"), result.latency, result.write_latency);
+    if (!result.uncorrected_latency.empty()) {
+      WriteCsvLatencies(out, total_prefix("total_uncorrected"), result.uncorrected_latency,
+                        result.uncorrected_write_latency);
+    }
+    for (int i = 0; i < kNumCachePaths; ++i) {
+      if (result.cache_latency[i].count > 0) {
+        WriteCsvLatency(out, total_prefix("total"), kCachePathString[i], result.cache_latency[i]);
+      }
+    }
+    for (size_t i = 0; i < result.phase_latency.size(); ++i) {
+      if (result.phase_latency[i].count > 0) {
+        std::string name = std::string("PHASE_") + kProfilePhaseString[i];
+        WriteCsvLatency(out, total_prefix("total"), name.c_str(), result.phase_latency[i]);
+      }
+    }
+    WriteCsvTxnSizeLatencies(out, total_prefix("total"), Operation::READTRANSACTION,
+                             result.read_txn_size_latency);
+    WriteCsvTxnSizeLatencies(out, total_prefix("total"), Operation::WRITETRANSACTION,
+                             result.write_txn_size_latency);
+
+    for (int i = 0; i < kNumOperations; ++i) {
+      OutcomeStats const &stats = result.outcomes[i];
+      if (stats.Requests() == 0) {
+        continue;
+      }
+      uint64_t ok = stats.outcomes[static_cast<int>(RequestOutcome::OK)];
+      std::ostringstream prefix;
+      prefix << config.str() << ",retries," << measured_window
+             << ",0," << stats.Requests() << ",,,,,"
+             << (result.measured_runtime_sec > 0 ? ok / result.measured_runtime_sec : 0)
+             << "," << stats.Requests() - ok << "," << stats.retries << ",,";
+      WriteCsvBackoff(out, prefix.str(), kOperationString[i], stats.backoff);
+    }
+
+    auto write_shards = [&](char const *scope, std::vector<ShardStats> const &shards) {
+      for (ShardStats const &stats : shards) {
+        std::ostringstream prefix;
+        prefix << config.str() << "," << scope << "," << measured_window
+               << ",0," << stats.ops << "," << stats.throughput
+               << ",," << stats.failed << ",,,,,,";
+        WriteCsvLatency(out, prefix.str(), CsvString(stats.name).c_str(), stats.latency);
+      }
+    };
+    write_shards("shard", result.shards);
+    write_shards("hotness", result.hotness_buckets);
+
+    for (ClientThreadStats const &stats : result.client_threads) {
+      std::ostringstream prefix;
+      prefix << config.str() << ",client," << measured_window
+             << ",0," << stats.completed_ops << "," << stats.throughput
+             << ",," << stats.failed_ops << ",,,,," << stats.overtime_ops << "," << stats.wait_share;
+      std::string name = "thread " + std::to_string(stats.thread);
+      WriteCsvLatency(out, prefix.str(), name.c_str(), stats.latency);
+    }
+
+    for (IntervalStats const &interval : result.intervals) {
+      std::ostringstream prefix;
+      prefix << config.str() << ",interval," << interval.start_sec << "," << interval.end_sec
+             << "," << interval.warmup << "," << interval.ops << "," << interval.throughput
+             << "," << interval.cache_hit_rate << "," << interval.failed << "," << interval.contention
+             << ",,,,,";
+      WriteCsvLatencies(out, prefix.str(), interval.latency, interval.write_latency);
+    }
+  }
+}
+
+} // benchmark
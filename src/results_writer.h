@@ -0,0 +1,94 @@
+#ifndef RESULTS_WRITER_H_
+#define RESULTS_WRITER_H_
+
+#include "client_stats.h"
+#include "experiment_loader.h"
+#include "measurements.h"
+#include "perf_counters.h"
+#include "properties.h"
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+// Everything reported about a single line of the experiments file.
+struct ExperimentResult {
+  ExperimentResult(ExperimentInfo const &info, utils::Properties const &props,
+                   MeasurementsSnapshot const &snapshot);
+
+  ExperimentInfo experiment;
+  std::string db_name;
+  std::string config_path;
+  double runtime_sec;
+  double measured_runtime_sec; // excluding warmup
+  double warmup_sec; // actual warmup; shorter than warmup_len if adaptive
+  uint64_t completed_ops; // excluding warmup
+  double throughput; // excluding warmup
+  uint64_t failed_ops;
+  uint64_t overtime_ops;
+  uint64_t contention;
+  double goodput; // requests that succeeded, possibly after retries, per second
+  double attempt_throughput; // attempts including retries per second
+  double abort_rate;
+  std::vector<OutcomeStats> outcomes; // indexed by Operation
+  double cache_hit_rate;
+  std::vector<LatencySummary> latency; // indexed by Operation
+  LatencySummary write_latency;
+  // Service time without queueing behind the intended start; only present for
+  // open-loop runs, where `latency` is corrected for coordinated omission.
+  std::vector<LatencySummary> uncorrected_latency;
+  LatencySummary uncorrected_write_latency;
+  std::vector<LatencySummary> cache_latency; // indexed by CachePath
+  std::vector<LatencySummary> phase_latency; // indexed by ProfilePhase; only if profiling
+  // indexed by TxnSizeBucket
+  std::vector<LatencySummary> read_txn_size_latency;
+  std::vector<LatencySummary> write_txn_size_latency;
+  std::vector<IntervalStats> intervals;
+  // Client thread counters after warmup and the number of requests they
+  // cover; only present with perf.counters.
+  PerfCounts perf;
+  uint64_t perf_ops;
+  // Requests as seen by each client thread, excluding warmup.
+  std::vector<ClientThreadStats> client_threads;
+  ClientImbalance client_imbalance;
+  // Only present with per-shard measurements.
+  std::vector<ShardStats> shards;
+  std::vector<ShardStats> hotness_buckets;
+};
+
+///
+/// Writes experiment results in a machine-readable format, so that sweeps over
+/// an experiments file can be diffed and plotted without scraping stdout.
+/// The file is rewritten after every experiment and always holds the results
+/// of all experiments completed so far.
+///
+class ResultsWriter {
+ public:
+  enum class Format {
+    kJson,
+    kCsv
+  };
+
+  ResultsWriter(std::string const &path, Format format);
+
+  // Returns nullptr unless the results.path property is set. The format is
+  // taken from results.format (json or csv) or else from the file extension.
+  static std::unique_ptr<ResultsWriter> Create(utils::Properties const &props);
+
+  void Add(ExperimentResult result);
+
+ private:
+  void WriteJson(std::ostream &out) const;
+  void WriteCsv(std::ostream &out) const;
+
+  std::string const path_;
+  Format const format_;
+  std::vector<ExperimentResult> results_;
+};
+
+} // benchmark
+
+#endif // RESULTS_WRITER_H_
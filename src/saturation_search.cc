@@ -0,0 +1,168 @@
+#include "saturation_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace benchmark {
+
+SaturationSearch::SaturationSearch(utils::Properties const &props)
+    : slo_op_(props.GetProperty("search.slo_op", "READ"))
+    , slo_percentile_(std::stod(props.GetProperty("search.slo_percentile", "99")))
+    , slo_percentile_index_(0)
+    , slo_us_(std::stod(props.GetProperty("search.slo_ms", "5")) * 1000)
+    , threads_(std::stoi(props.GetProperty("search.threads", "16")))
+    , warmup_len_(std::stod(props.GetProperty("search.warmup_len", "10")))
+    , exp_len_(std::stod(props.GetProperty("search.exp_len", "30")))
+    , tolerance_(std::stod(props.GetProperty("search.tolerance", "0.05")))
+    , max_probes_(std::stoi(props.GetProperty("search.max_probes", "12")))
+    , min_achieved_(std::stod(props.GetProperty("search.min_achieved", "0.95")))
+{
+  std::string dimension = props.GetProperty("search.dimension", "threads");
+  if (dimension != "threads" && dimension != "throughput") {
+    throw std::invalid_argument("Unknown search.dimension '" + dimension
+                                + "'; expected threads or throughput");
+  }
+  search_threads_ = dimension == "threads";
+  if (!search_threads_ && props.GetProperty("search.max").empty()) {
+    throw std::invalid_argument("search.max (ops/sec) is required when searching throughput");
+  }
+  min_ = std::stod(props.GetProperty("search.min", "1"));
+  max_ = std::stod(props.GetProperty("search.max", "1024"));
+  if (min_ <= 0 || max_ < min_) {
+    throw std::invalid_argument("search.min and search.max must satisfy 0 < min <= max");
+  }
+
+  bool valid_op = slo_op_ == "WRITE";
+  for (int i = 0; i < kNumOperations; ++i) {
+    valid_op |= slo_op_ == kOperationString[i];
+  }
+  if (!valid_op) {
+    throw std::invalid_argument("Unknown search.slo_op '" + slo_op_ + "'");
+  }
+  auto const *percentile = std::find(std::begin(kReportedPercentiles),
+                                     std::end(kReportedPercentiles), slo_percentile_);
+  if (percentile == std::end(kReportedPercentiles)) {
+    throw std::invalid_argument("search.slo_percentile must be one of the reported percentiles");
+  }
+  slo_percentile_index_ = percentile - std::begin(kReportedPercentiles);
+}
+
+int SaturationSearch::MaxThreads() const {
+  return search_threads_ ? static_cast<int>(max_) : threads_;
+}
+
+ExperimentInfo SaturationSearch::ExperimentAt(double load) const {
+  if (search_threads_) {
+    return ExperimentInfo(static_cast<int>(load), warmup_len_, exp_len_);
+  }
+  return ExperimentInfo(threads_, warmup_len_, exp_len_, load);
+}
+
+double SaturationSearch::SloLatency(ExperimentResult const &result) const {
+  LatencySummary const *latency = nullptr;
+  if (slo_op_ == "WRITE") {
+    latency = &result.write_latency;
+  }
+  for (int i = 0; i < kNumOperations; ++i) {
+    if (slo_op_ == kOperationString[i]) {
+      latency = &result.latency[i];
+    }
+  }
+  if (latency == nullptr) {
+    return 0;
+  }
+  // an empty histogram would count as meeting any SLO
+  if (latency->count == 0) {
+    throw std::runtime_error("Probe recorded no " + slo_op_ + " operations; "
+                             "check search.slo_op against the workload");
+  }
+  return latency->percentiles[slo_percentile_index_] / 1000.0;
+}
+
+std::string SaturationSearch::SloDescription() const {
+  return slo_op_ + " p" + PercentileLabel(slo_percentile_) + " < "
+         + PercentileLabel(slo_us_ / 1000) + " ms";
+}
+
+SearchProbe SaturationSearch::Probe(ProbeFunction const &probe, double load) {
+  ExperimentInfo experiment = ExperimentAt(load);
+  std::cout << "Saturation search probe: " << (search_threads_ ? "threads = " : "target ops/sec = ")
+            << load << std::endl;
+  ExperimentResult result = probe(experiment);
+  double latency_us = SloLatency(result);
+  bool sustainable = latency_us < slo_us_;
+  if (!search_threads_) {
+    sustainable &= result.throughput >= min_achieved_ * load;
+  }
+  std::cout << "Saturation search probe result: " << result.throughput << " ops/sec, "
+            << slo_op_ << " p" << PercentileLabel(slo_percentile_) << " = " << latency_us << " us, "
+            << (sustainable ? "sustainable" : "not sustainable") << std::endl;
+  return {experiment, result.throughput, latency_us, sustainable};
+}
+
+std::vector<SearchProbe> SaturationSearch::Run(ProbeFunction const &probe) {
+  std::vector<SearchProbe> probes;
+  double lo = search_threads_ ? std::round(min_) : min_;
+  double hi = search_threads_ ? std::round(max_) : max_;
+
+  probes.push_back(Probe(probe, lo));
+  if (!probes.back().sustainable || hi == lo) {
+    return probes;
+  }
+  probes.push_back(Probe(probe, hi));
+  if (probes.back().sustainable) {
+    return probes;
+  }
+
+  // invariant: lo is sustainable, hi is not
+  while (static_cast<int>(probes.size()) < max_probes_) {
+    double gap = hi - lo;
+    if (search_threads_ ? gap <= std::max(1.0, std::floor(lo * tolerance_)) : gap <= lo * tolerance_) {
+      break;
+    }
+    double mid = search_threads_ ? std::floor((lo + hi) / 2) : (lo + hi) / 2;
+    probes.push_back(Probe(probe, mid));
+    if (probes.back().sustainable) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return probes;
+}
+
+void SaturationSearch::PrintCurve(std::ostream &out, std::vector<SearchProbe> const &probes) const {
+  std::vector<SearchProbe> curve = probes;
+  std::sort(curve.begin(), curve.end(), [](SearchProbe const &a, SearchProbe const &b) {
+    return a.experiment.num_threads != b.experiment.num_threads
+           ? a.experiment.num_threads < b.experiment.num_threads
+           : a.experiment.target_throughput < b.experiment.target_throughput;
+  });
+
+  out << "Saturation search (" << SloDescription() << "):" << std::endl;
+  out << "threads,target_throughput,throughput," << slo_op_ << "_p"
+      << PercentileLabel(slo_percentile_) << "_us,sustainable" << std::endl;
+  SearchProbe const *best = nullptr;
+  for (SearchProbe const &probe : curve) {
+    out << probe.experiment.num_threads << "," << probe.experiment.target_throughput << ","
+        << probe.throughput << "," << probe.latency_us << "," << probe.sustainable << std::endl;
+    if (probe.sustainable && (best == nullptr || probe.throughput > best->throughput)) {
+      best = &probe;
+    }
+  }
+
+  if (best == nullptr) {
+    out << "Operating point: none; even the smallest probe missed the SLO" << std::endl;
+    return;
+  }
+  out << "Operating point: " << best->experiment.num_threads << " threads";
+  if (best->experiment.target_throughput > 0) {
+    out << ", " << best->experiment.target_throughput << " ops/sec (target)";
+  }
+  out << ", " << best->throughput << " ops/sec, " << slo_op_ << " p"
+      << PercentileLabel(slo_percentile_) << " = " << best->latency_us << " us" << std::endl;
+}
+
+} // benchmark
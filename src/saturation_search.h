@@ -0,0 +1,83 @@
+#ifndef SATURATION_SEARCH_H_
+#define SATURATION_SEARCH_H_
+
+#include "experiment_loader.h"
+#include "properties.h"
+#include "results_writer.h"
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+// Outcome of one probe experiment of a saturation search.
+struct SearchProbe {
+  ExperimentInfo experiment;
+  double throughput; // achieved, excluding warmup
+  double latency_us; // SLO percentile of the SLO operation
+  bool sustainable;
+};
+
+///
+/// Finds the highest throughput the system sustains under a latency SLO, e.g.
+/// READ p99 below 5 ms, by binary-searching either the number of closed-loop
+/// client threads or the offered load of open-loop clients. Each step runs a
+/// short probe experiment. A probe is sustainable if it meets the SLO and, when
+/// open-loop, achieves at least search.min_achieved of the offered load.
+///
+/// Properties:
+///   search.slo_op          operation the SLO applies to, or WRITE (default READ)
+///   search.slo_percentile  one of the reported percentiles (default 99)
+///   search.slo_ms          latency bound in milliseconds (default 5)
+///   search.dimension       threads or throughput (default threads)
+///   search.min, search.max range to search; for threads the default is 1-1024,
+///                          for throughput (total ops/sec) search.max is required
+///   search.threads         client threads when searching throughput (default 16)
+///   search.warmup_len      probe warmup in seconds (default 10)
+///   search.exp_len         probe length in seconds (default 30)
+///   search.tolerance       stop once the bounds are within this fraction of
+///                          each other (default 0.05)
+///   search.max_probes      upper bound on the number of probes (default 12)
+///   search.min_achieved    see above (default 0.95)
+///
+class SaturationSearch {
+ public:
+  using ProbeFunction = std::function<ExperimentResult(ExperimentInfo const &)>;
+
+  explicit SaturationSearch(utils::Properties const &props);
+
+  // Runs probes until the search converges; returns them in the order run.
+  std::vector<SearchProbe> Run(ProbeFunction const &probe);
+
+  // Largest number of client threads any probe can use.
+  int MaxThreads() const;
+
+  // Prints the probes sorted by load and the chosen operating point.
+  void PrintCurve(std::ostream &out, std::vector<SearchProbe> const &probes) const;
+
+ private:
+  SearchProbe Probe(ProbeFunction const &probe, double load);
+  ExperimentInfo ExperimentAt(double load) const;
+  double SloLatency(ExperimentResult const &result) const;
+  std::string SloDescription() const;
+
+  std::string slo_op_;
+  double slo_percentile_;
+  size_t slo_percentile_index_;
+  double slo_us_;
+  bool search_threads_;
+  double min_;
+  double max_;
+  int threads_;
+  double warmup_len_;
+  double exp_len_;
+  double tolerance_;
+  int max_probes_;
+  double min_achieved_;
+};
+
+} // benchmark
+
+#endif // SATURATION_SEARCH_H_
@@ -0,0 +1,68 @@
+#include "steady_state.h"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace benchmark {
+
+namespace {
+  // Infinite for an empty or all-zero window, so that an idle system never
+  // counts as stable.
+  double CoefficientOfVariation(std::deque<double> const &values) {
+    double sum = 0;
+    for (double value : values) {
+      sum += value;
+    }
+    double mean = values.empty() ? 0 : sum / values.size();
+    if (mean <= 0) {
+      return std::numeric_limits<double>::infinity();
+    }
+    double squares = 0;
+    for (double value : values) {
+      squares += (value - mean) * (value - mean);
+    }
+    return std::sqrt(squares / values.size()) / mean;
+  }
+}
+
+SteadyStateDetector::SteadyStateDetector(int window, double max_cov)
+    : window_(window)
+    , max_cov_(max_cov)
+{
+  if (window < 2) {
+    throw std::invalid_argument("warmup.window must be at least 2 intervals");
+  }
+}
+
+std::unique_ptr<SteadyStateDetector> SteadyStateDetector::Create(utils::Properties const &props) {
+  if (props.GetProperty("warmup.adaptive", "false") != "true") {
+    return nullptr;
+  }
+  return std::make_unique<SteadyStateDetector>(
+    std::stoi(props.GetProperty("warmup.window", "5")),
+    std::stod(props.GetProperty("warmup.max_cov", "0.05")));
+}
+
+bool SteadyStateDetector::AddInterval(IntervalStats const &interval) {
+  throughput_.push_back(interval.throughput);
+  p99_.push_back(static_cast<double>(interval.p99));
+  if (throughput_.size() > window_) {
+    throughput_.pop_front();
+    p99_.pop_front();
+  }
+  return throughput_.size() == window_
+         && CoefficientOfVariation(throughput_) <= max_cov_
+         && CoefficientOfVariation(p99_) <= max_cov_;
+}
+
+std::string SteadyStateDetector::Describe() const {
+  std::ostringstream out;
+  out.precision(3);
+  out << "throughput cov=" << CoefficientOfVariation(throughput_)
+      << ", p99 cov=" << CoefficientOfVariation(p99_);
+  return out.str();
+}
+
+} // benchmark
@@ -0,0 +1,52 @@
+#ifndef STEADY_STATE_H_
+#define STEADY_STATE_H_
+
+#include "measurements.h"
+#include "properties.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace benchmark {
+
+///
+/// Decides when an experiment has warmed up by watching its status intervals:
+/// the system counts as stable once the throughput and the p99 latency of the
+/// last few intervals each have a coefficient of variation (stddev / mean)
+/// below a threshold. Caches in memcached and the database warm up at very
+/// different rates depending on the workload, so this replaces guessing a
+/// fixed warmup length.
+///
+/// Properties:
+///   warmup.adaptive  end warmup once stable (default false); warmup_len of
+///                    the experiment becomes the upper bound
+///   warmup.window    number of consecutive intervals to compare (default 5)
+///   warmup.max_cov   largest coefficient of variation that counts as stable
+///                    (default 0.05)
+///
+class SteadyStateDetector {
+ public:
+  SteadyStateDetector(int window, double max_cov);
+
+  // Returns nullptr unless warmup.adaptive is set.
+  static std::unique_ptr<SteadyStateDetector> Create(utils::Properties const &props);
+
+  // Adds the next interval; returns whether the last `window` intervals are
+  // stable.
+  bool AddInterval(IntervalStats const &interval);
+
+  // Coefficients of variation over the current window, e.g.
+  // "throughput cov=0.012, p99 cov=0.034".
+  std::string Describe() const;
+
+ private:
+  const size_t window_;
+  const double max_cov_;
+  std::deque<double> throughput_;
+  std::deque<double> p99_;
+};
+
+} // benchmark
+
+#endif // STEADY_STATE_H_
@@ -6,55 +6,55 @@ namespace benchmark {
     std::vector<DB::TimestampValue> read_results;
     db.Execute({
       DataTable::Edges,
-      {{"id1", 0}, {"id2", 1}, {"type", static_cast<int64_t>(EdgeType::Unique)}},
+      {0, 1, static_cast<int64_t>(EdgeType::Unique)},
       {utils::CurrentTimeNanos(), "e1"},
       Operation::INSERT
     }, read_results);
     db.Execute({
       DataTable::Edges,
-      {{"id1", 1}, {"id2", 2}, {"type", static_cast<int64_t>(EdgeType::Other)}},
+      {1, 2, static_cast<int64_t>(EdgeType::Other)},
       {utils::CurrentTimeNanos(), "e2"},
       Operation::INSERT
     }, read_results);
     db.Execute({
       DataTable::Edges,
-      {{"id1", 0}, {"id2", 2}, {"type", static_cast<int64_t>(EdgeType::Bidirectional)}},
+      {0, 2, static_cast<int64_t>(EdgeType::Bidirectional)},
       {utils::CurrentTimeNanos(), "e3"},
       Operation::INSERT
     }, read_results);
     db.Execute({
       DataTable::Edges,
-      {{"id1", 3}, {"id2", 4}, {"type", static_cast<int64_t>(EdgeType::Other)}},
+      {3, 4, static_cast<int64_t>(EdgeType::Other)},
       {utils::CurrentTimeNanos(), "e4"},
       Operation::INSERT
     }, read_results);
     db.Execute({
       DataTable::Objects,
-      {{"id", 0}},
+      {0, 0, 0},
       {utils::CurrentTimeNanos(), "o1"},
       Operation::INSERT
     }, read_results);
     db.Execute({
       DataTable::Objects,
-      {{"id", 1}},
+      {1, 0, 0},
       {utils::CurrentTimeNanos(), "o2"},
       Operation::INSERT
     }, read_results);
     db.Execute({
       DataTable::Objects,
-      {{"id", 2}},
+      {2, 0, 0},
       {utils::CurrentTimeNanos(), "o3"},
       Operation::INSERT
     }, read_results);
     db.Execute({
       DataTable::Objects,
-      {{"id", 3}},
+      {3, 0, 0},
       {utils::CurrentTimeNanos(), "o4"},
       Operation::INSERT
     }, read_results);
     db.Execute({
       DataTable::Objects,
-      {{"id", 4}},
+      {4, 0, 0},
       {utils::CurrentTimeNanos(), "o5"},
       Operation::INSERT
     }, read_results);
@@ -64,7 +64,7 @@ namespace benchmark {
     std::vector<DB::TimestampValue> before_results;
     db.Execute({
       DataTable::Objects,
-      {{"id", 3}},
+      {3, 0, 0},
       {utils::CurrentTimeNanos(), ""},
       Operation::READ
     }, before_results);
@@ -74,7 +74,7 @@ namespace benchmark {
 
     db.Execute({
       DataTable::Edges,
-      {{"id1",3}, {"id2", 4}, {"type", static_cast<int64_t>(EdgeType::Other)}},
+      {3, 4, static_cast<int64_t>(EdgeType::Other)},
       {utils::CurrentTimeNanos(), ""},
       Operation::READ
     }, before_results);
@@ -83,21 +83,21 @@ namespace benchmark {
     before_results.clear();
     db.Execute({
       DataTable::Objects,
-      {{"id", 3}},
+      {3, 0, 0},
       {utils::CurrentTimeNanos(), "o4-n"},
       Operation::UPDATE
     }, before_results);
 
     db.Execute({
       DataTable::Edges,
-      {{"id1", 3}, {"id2", 4,}, {"type", static_cast<int64_t>(EdgeType::Other)}},
+      {3, 4, static_cast<int64_t>(EdgeType::Other)},
       {utils::CurrentTimeNanos(), "e4-n"},
       Operation::UPDATE
     }, before_results);
 
     db.Execute({
       DataTable::Objects,
-      {{"id", 3}},
+      {3, 0, 0},
       {0, ""},
       Operation::READ
     }, before_results);
@@ -107,7 +107,7 @@ namespace benchmark {
 
     db.Execute({
       DataTable::Edges,
-      {{"id1", 3}, {"id2", 4}, {"type", static_cast<int64_t>(EdgeType::Other)}},
+      {3, 4, static_cast<int64_t>(EdgeType::Other)},
       {0, ""},
       Operation::READ
     }, before_results);
@@ -117,14 +117,14 @@ namespace benchmark {
 
     db.Execute({
       DataTable::Objects,
-      {{"id", 3}},
+      {3, 0, 0},
       {utils::CurrentTimeNanos(), ""},
       Operation::DELETE
     }, before_results);
 
     db.Execute({
       DataTable::Edges,
-      {{"id1", 3}, {"id2", 4}, {"type", static_cast<int64_t>(EdgeType::Other)}},
+      {3, 4, static_cast<int64_t>(EdgeType::Other)},
       {utils::CurrentTimeNanos(), ""},
       Operation::DELETE
     }, before_results);
@@ -6,12 +6,16 @@
 #include <chrono>
 #include <string>
 
+#include "tsc_clock.h"
+
 namespace benchmark {
 
 namespace utils {
 
- // returns number of nanoseconds since epoch
-int64_t CurrentTimeNanos();
+// returns number of nanoseconds since epoch; see TscClock
+inline int64_t CurrentTimeNanos() {
+  return TscClock::now().time_since_epoch().count();
+}
 
 template <typename R, typename P = std::ratio<1>>
 class Timer {
@@ -34,7 +38,7 @@ class Timer {
 
  private:
   using Duration = std::chrono::duration<R, P>;
-  using Clock = std::chrono::high_resolution_clock;
+  using Clock = TscClock;
 
   Clock::time_point time_;
 };
@@ -0,0 +1,61 @@
+#include "tsc_clock.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace benchmark {
+
+namespace utils {
+
+namespace {
+  // The TSC is only usable as a clock if it ticks at a constant rate
+  // regardless of frequency scaling and sleep states, and is synchronized
+  // across cores (CPUID.80000007H:EDX[8]).
+  bool HasInvariantTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+      return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+  }
+
+  int64_t SystemNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+}
+
+TscCalibration Calibrate() {
+  using namespace std::chrono;
+  TscCalibration calibration {false, 1.0, 0, 0};
+#if defined(__x86_64__) || defined(__i386__)
+  if (HasInvariantTsc()) {
+    // spin rather than sleep so that the thread is not descheduled while we measure
+    steady_clock::time_point start = steady_clock::now();
+    uint64_t start_ticks = __rdtsc();
+    steady_clock::time_point end;
+    do {
+      end = steady_clock::now();
+    } while (end - start < milliseconds(50));
+    uint64_t ticks = __rdtsc() - start_ticks;
+    calibration.use_tsc = true;
+    calibration.nanos_per_tick = duration_cast<duration<double, std::nano>>(end - start).count() / ticks;
+    calibration.anchor_ticks = __rdtsc();
+    calibration.anchor_nanos = SystemNanos();
+    return calibration;
+  }
+#endif
+  calibration.anchor_ticks = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+  calibration.anchor_nanos = SystemNanos();
+  return calibration;
+}
+
+} // utils
+
+} // benchmark
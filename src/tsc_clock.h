@@ -0,0 +1,77 @@
+#ifndef TSC_CLOCK_H_
+#define TSC_CLOCK_H_
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace benchmark {
+
+namespace utils {
+
+// How ticks relate to wall-clock time; measured once per process.
+struct TscCalibration {
+  // false if the CPU has no invariant TSC, in which case ticks are
+  // steady_clock nanoseconds
+  bool use_tsc;
+  double nanos_per_tick;
+  uint64_t anchor_ticks;
+  int64_t anchor_nanos; // system_clock nanoseconds since epoch at anchor_ticks
+};
+
+TscCalibration Calibrate();
+
+inline const TscCalibration &Calibration() {
+  static const TscCalibration calibration = Calibrate();
+  return calibration;
+}
+
+// Reads the CPU's time stamp counter, which costs a few cycles instead of the
+// tens of nanoseconds of a clock_gettime call. Only differences between
+// readings are meaningful; convert them with TicksToNanos. Without an
+// invariant TSC (or on other architectures) this reads steady_clock instead.
+inline uint64_t ReadTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+  if (Calibration().use_tsc) {
+    return __rdtsc();
+  }
+#endif
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline uint64_t TicksToNanos(uint64_t ticks) {
+  return static_cast<uint64_t>(ticks * Calibration().nanos_per_tick);
+}
+
+///
+/// Clock backed by the time stamp counter, in the std::chrono clock interface.
+/// It is steady, and its epoch is the system_clock epoch as of calibration, so
+/// it can stand in for both; it does not follow later adjustments of the
+/// system time.
+///
+struct TscClock {
+  using rep = int64_t;
+  using period = std::nano;
+  using duration = std::chrono::nanoseconds;
+  using time_point = std::chrono::time_point<TscClock>;
+  static constexpr bool is_steady = true;
+
+  static time_point now() noexcept {
+    const TscCalibration &calibration = Calibration();
+    // signed, as a core whose counter lags the calibrating core's may read
+    // slightly behind the anchor
+    int64_t ticks = static_cast<int64_t>(ReadTicks()) - static_cast<int64_t>(calibration.anchor_ticks);
+    int64_t since_anchor = static_cast<int64_t>(ticks * calibration.nanos_per_tick);
+    return time_point(duration(calibration.anchor_nanos + since_anchor));
+  }
+};
+
+} // utils
+
+} // benchmark
+
+#endif // TSC_CLOCK_H_
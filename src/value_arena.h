@@ -0,0 +1,53 @@
+#ifndef VALUE_ARENA_H_
+#define VALUE_ARENA_H_
+
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace benchmark {
+
+///
+/// A block of random lowercase letters, generated once, from which values are
+/// handed out as views at random offsets. Generating a value byte by byte for
+/// every write showed up in client profiles; a view costs one random draw.
+/// Values of the same size overlap, so the arena should be much larger than
+/// a value, or databases that compress pages may find repeated substrings.
+///
+/// Get is const, but keep one arena per thread anyway: the arena is then
+/// filled on the thread that uses it.
+///
+class ValueArena {
+ public:
+  template <typename URNG>
+  ValueArena(size_t size, URNG &gen) : bytes_(size, 'a') {
+    std::uniform_int_distribution<int> letter(0, 25);
+    for (char &c : bytes_) {
+      c = static_cast<char>('a' + letter(gen));
+    }
+  }
+
+  // A random value of @param size bytes, valid as long as the arena.
+  template <typename URNG>
+  std::string_view Get(size_t size, URNG &gen) const {
+    if (size > bytes_.size()) {
+      throw std::invalid_argument("Value of " + std::to_string(size) + " bytes does not fit a value arena of "
+                                  + std::to_string(bytes_.size()) + " bytes");
+    }
+    std::uniform_int_distribution<size_t> offset(0, bytes_.size() - size);
+    return std::string_view(bytes_).substr(offset(gen), size);
+  }
+
+  size_t size() const {
+    return bytes_.size();
+  }
+
+ private:
+  std::string bytes_;
+};
+
+} // benchmark
+
+#endif // VALUE_ARENA_H_
@@ -6,48 +6,71 @@
 // #include "const_generator.h"
 #include "workload.h"
 #include "constants.h"
+#include "value_arena.h"
 // #include "random_byte_generator.h"
 
 #include <algorithm>
+#include <memory>
+#include <optional>
 #include <random>
 #include <string>
 
 namespace benchmark {
 
   // Each loader contains a map from primary shard to a list of edges;
-  // Returns the combined map
-  inline std::unordered_map<int, std::vector<Edge>> CombineKeyMaps(std::vector<std::shared_ptr<WorkloadLoader>> const & loaders)
+  // Returns the combined edges, indexed by shard
+  inline std::vector<std::vector<Edge>> CombineKeyMaps(std::vector<std::shared_ptr<WorkloadLoader>> const & loaders)
   {
-    std::unordered_map<int, std::vector<Edge>> map;
+    std::vector<std::vector<Edge>> combined(constants::NUM_SHARDS);
     for (auto const & loader : loaders) {
       auto & loader_map = loader->shard_to_edges;
       for (auto map_it = loader_map.begin(); map_it != loader_map.end(); ++map_it) {
-        std::vector<Edge> & already_mapped = map[map_it->first];
+        if (map_it->first >= static_cast<int>(combined.size())) {
+          combined.resize(map_it->first + 1);
+        }
+        std::vector<Edge> & already_mapped = combined[map_it->first];
         already_mapped.insert(already_mapped.end(), map_it->second.begin(), map_it->second.end());
       }
       loader_map.clear();
     }
-    return map;
+    return combined;
+  }
+
+  // Sampling a primary shard until it has edges draws from the shards that
+  // do with their weights.
+  inline std::optional<AliasSampler> EdgeShardSampler(WorkloadConfig const & config,
+                                                      std::vector<std::vector<Edge>> const & shard_to_edges)
+  {
+    std::vector<double> weights = config.primary_shard_weights;
+    bool any = false;
+    for (size_t shard = 0; shard < weights.size(); ++shard) {
+      if (shard >= shard_to_edges.size() || shard_to_edges[shard].empty()) {
+        weights[shard] = 0;
+      }
+      any = any || weights[shard] > 0;
+    }
+    if (!any) {
+      return std::nullopt;
+    }
+    return AliasSampler(weights);
   }
   
   TraceGeneratorWorkload::TraceGeneratorWorkload(utils::Properties const & p,
-          std::vector<std::shared_ptr<WorkloadLoader>> const & loaders)
-      : config_parser(p.GetProperty("config_path"))
+          std::vector<std::shared_ptr<WorkloadLoader>> const & loaders,
+          Measurements *measurements)
+      : config(p.GetProperty("config_path"), constants::NUM_SHARDS)
       , object_table(p.GetProperty("object_table"))
       , edge_table(p.GetProperty("edge_table"))
       , shard_to_edges(CombineKeyMaps(loaders)) // only used in run phase
+      , edge_shards(EdgeShardSampler(config, shard_to_edges))
+      , measurements(measurements)
+      , max_contention_retries(std::stoi(p.GetProperty("contention.max_retries", "-1")))
+      , value_arena_bytes(std::stoul(p.GetProperty("value.arena_bytes", "1048576")))
   {
-    // Check fields were loaded correctly from configs in debug mode.
-    assert(config_parser.fields.find("write_txn_sizes") != config_parser.fields.end());
-    assert(config_parser.fields.find("operations") != config_parser.fields.end());
-    assert(config_parser.fields.find("primary_shards") != config_parser.fields.end());
-    assert(config_parser.fields.find("remote_shards") != config_parser.fields.end());
-    assert(config_parser.fields.find("edge_types") != config_parser.fields.end());
-    assert(config_parser.fields.find("read_txn_operation_types") != config_parser.fields.end());
-    assert(config_parser.fields.find("read_operation_types") != config_parser.fields.end());
-    assert(config_parser.fields.find("write_operation_types") != config_parser.fields.end());
-    assert(config_parser.fields.find("read_txn_sizes") != config_parser.fields.end());
-    ResizeShardWeights(constants::NUM_SHARDS);
+    if (value_arena_bytes < static_cast<size_t>(config.MaxValueSize())) {
+      throw std::invalid_argument("value.arena_bytes must be at least the largest value size of "
+                                  + std::to_string(config.MaxValueSize()) + " bytes");
+    }
   }
 
   TraceGeneratorWorkload::TraceGeneratorWorkload(utils::Properties const & p)
@@ -60,10 +83,9 @@ namespace benchmark {
   }
 
   long TraceGeneratorWorkload::GetNumKeys(long num_requests) {
-    ConfigParser::LineObject & obj = config_parser.fields["write_txn_sizes"];
     long num_keys = 0;
     for (long i = 0; i < num_requests; ++i) {
-      num_keys += obj.vals[obj.distribution(rnd::gen)];
+      num_keys += config.write_txn_sizes(rnd::gen);
     }
     num_keys *= constants::KEY_POOL_FACTOR;
     return num_keys;
@@ -89,38 +111,70 @@ namespace benchmark {
 
   long TraceGeneratorWorkload::GetNumLoadedEdges() {
     long total_size = 0;
-    for (auto const & [key, value] : shard_to_edges) {
-      total_size += value.size();
+    for (std::vector<Edge> const & edges : shard_to_edges) {
+      total_size += edges.size();
     }
     return total_size;
   }
 
-  bool TraceGeneratorWorkload::DoRequest(DB & db) {
+  template <typename Request>
+  bool TraceGeneratorWorkload::ExecuteWithRetries(Operation op, Request const & request) {
     int64_t backoff_limit = constants::INITIAL_BACKOFF_LIMIT_MICROS;
+    int retries = 0;
+    uint64_t backoff_nanos = 0;
+    utils::Timer<uint64_t, std::nano> backoff_timer;
     Status result;
-    while ((result = DispatchRequest(db)) == Status::kContentionError) {
-      std::uniform_int_distribution<> unif(0, backoff_limit);
-      int64_t backoff_micros = unif(rnd::gen);
-      std::cerr << "Retrying operation due to contention error; sleep for " << backoff_micros << "us" 
-	        << std::endl;
-      std::this_thread::sleep_for(std::chrono::microseconds(backoff_micros));
+    while ((result = request()) == Status::kContentionError
+           && (max_contention_retries < 0 || retries < max_contention_retries)) {
+      std::uniform_int_distribution<int64_t> unif(0, backoff_limit);
+      backoff_timer.Start();
+      std::this_thread::sleep_for(std::chrono::microseconds(unif(rnd::gen)));
+      backoff_nanos += backoff_timer.End();
       backoff_limit = std::max(backoff_limit * 2, backoff_limit); // don't overflow
+      retries++;
+    }
+    if (measurements != nullptr) {
+      ScopedPhase phase(measurements, ProfilePhase::RECORD);
+      measurements->ReportOutcome(op, result, retries, backoff_nanos);
     }
     return result == Status::kOK;
   }
 
-  Status TraceGeneratorWorkload::DispatchRequest(DB &db) {
-    std::discrete_distribution<> op_dist = config_parser.fields["operations"].distribution;
-    std::vector<DB::TimestampValue> read_buffer;
-    switch (op_dist(rnd::gen)) {
-      case 0:
-        return db.Execute(GetReadOperation(false), read_buffer);
-      case 1:
-        return db.Execute(GetWriteOperation(false), read_buffer);
-      case 2:
-        return db.ExecuteTransaction(GetReadTransaction(), read_buffer, true);
-      case 3:
-        return db.ExecuteTransaction(GetWriteTransaction(), read_buffer, false);
+  // A contended request is retried as is, rather than replaced by a new one,
+  // so that its outcome is attributed to the right operation type.
+  bool TraceGeneratorWorkload::DoRequest(DB & db) {
+    std::optional<ScopedPhase> phase(std::in_place, measurements, ProfilePhase::SELECT_REQUEST);
+    RequestKind request_kind = config.operations(rnd::gen);
+    phase.emplace(measurements, ProfilePhase::GENERATE_REQUEST);
+    switch (request_kind) {
+      case RequestKind::READ:
+      case RequestKind::WRITE: {
+        DB::DB_Operation const operation = request_kind == RequestKind::READ
+                                           ? GetReadOperation(false)
+                                           : GetWriteOperation(false);
+        phase.reset();
+        return ExecuteWithRetries(operation.operation, [&] {
+          std::vector<DB::TimestampValue> read_buffer;
+          return db.Execute(operation, read_buffer);
+        });
+      }
+      case RequestKind::READ_TRANSACTION:
+      case RequestKind::WRITE_TRANSACTION: {
+        bool read_only = request_kind == RequestKind::READ_TRANSACTION;
+        // reused across requests so that its capacity is only allocated once
+        thread_local std::vector<DB::DB_Operation> operations;
+        operations.clear();
+        if (read_only) {
+          GetReadTransaction(operations);
+        } else {
+          GetWriteTransaction(operations);
+        }
+        phase.reset();
+        return ExecuteWithRetries(read_only ? Operation::READTRANSACTION : Operation::WRITETRANSACTION, [&] {
+          std::vector<DB::TimestampValue> read_buffer;
+          return db.ExecuteTransaction(operations, read_buffer, read_only);
+        });
+      }
       default:
         throw std::invalid_argument("Distribution result out of bounds");
     }
@@ -129,58 +183,19 @@ namespace benchmark {
   // This function is used in the batch insert phase to generate an edge with new primary and remote keys.
   int TraceGeneratorWorkload::LoadRow(WorkloadLoader &loader, int write_batch_size) {
     std::uniform_int_distribution<> unif(0, constants::NUM_SHARDS-1);
-    ConfigParser::LineObject & remote_shards = config_parser.fields["remote_shards"];
     int primary_shard = unif(rnd::gen);
-    int remote_shard = remote_shards.distribution(rnd::gen);
+    int remote_shard = config.remote_shards(rnd::gen);
     int64_t primary_key = GenerateKey(primary_shard);
     int64_t remote_key = GenerateKey(remote_shard);
     EdgeType edge_type = GetRandomEdgeType();
     int64_t timestamp = utils::CurrentTimeNanos();
-    std::string value = GetValue();
-    return loader.WriteToBuffers(primary_shard, primary_key, remote_key, edge_type, timestamp, value, write_batch_size);
-  }
-
-  void TraceGeneratorWorkload::ResizeShardWeights(int n_shards) {
-
-    // only resize if we need to shrink, otherwise just assume extra shards have weight 0 (?)
-
-    ConfigParser::LineObject & primary_shards = config_parser.fields["primary_shards"];
-    ConfigParser::LineObject & remote_shards = config_parser.fields["remote_shards"];
-
-    if (primary_shards.weights.size() > n_shards) {
-      std::vector<double> primary_old_weights = std::move(primary_shards.weights);
-      primary_shards.weights = std::vector<double>(n_shards);
-      double interval = (1.0 * primary_old_weights.size()) / n_shards;
-      for (size_t oldi = 0, newi = 0; newi < n_shards; ++newi) {
-        double point_mass = 0;
-        while ((double) oldi < interval * (newi+1)) {
-          point_mass += primary_old_weights[oldi++];
-        }
-        primary_shards.weights[newi] = point_mass;
-      }
-      primary_shards.distribution = std::discrete_distribution<>(primary_shards.weights.begin(),
-                                                                 primary_shards.weights.end());
-    }
-
-    if (remote_shards.weights.size() > n_shards) {
-      std::vector<double> remote_old_weights = std::move(primary_shards.weights);
-      remote_shards.weights = std::vector<double>(n_shards);
-      double interval = (1.0 * remote_old_weights.size()) / n_shards;
-      for (size_t oldi = 0, newi = 0; newi < n_shards; ++newi) {
-        double point_mass = 0;
-        while ((double) oldi < interval * (newi+1)) {
-          point_mass += remote_old_weights[oldi++];
-        }
-        remote_shards.weights[newi] = point_mass;
-      }
-      remote_shards.distribution = std::discrete_distribution<>(remote_shards.weights.begin(),
-                                                                remote_shards.weights.end());
-    }
+    return loader.WriteToBuffers(primary_shard, primary_key, remote_key, edge_type, timestamp,
+                                 GetValue(DataTable::Edges), GetValue(DataTable::Objects),
+                                 GetValue(DataTable::Objects), write_batch_size);
   }
 
   EdgeType TraceGeneratorWorkload::GetRandomEdgeType() {
-    ConfigParser::LineObject & obj = config_parser.fields["edge_types"];
-    return EdgeStringToType(obj.types[obj.distribution(rnd::gen)]);
+    return config.edge_types(rnd::gen);
   }
 
   int64_t TraceGeneratorWorkload::GenerateKey(int shard) {
@@ -193,117 +208,97 @@ namespace benchmark {
         (timestamp & 0xFFFFFFFFFF);
   }
 
-  std::string TraceGeneratorWorkload::GetRandomReadOperationType(bool is_txn_op) {
-    ConfigParser::LineObject & obj = config_parser.fields[is_txn_op ? "read_txn_operation_types"
-                                                                    : "read_operation_types"];
-    return obj.types[obj.distribution(rnd::gen)];
+  OperationKind const & TraceGeneratorWorkload::GetRandomReadOperationType(bool is_txn_op) {
+    return is_txn_op ? config.read_txn_operation_types(rnd::gen) : config.read_operation_types(rnd::gen);
   }
 
-  std::string TraceGeneratorWorkload::GetRandomWriteOperationType(bool is_txn_op) {
-    ConfigParser::LineObject & obj = config_parser.fields[is_txn_op ? "write_txn_operation_types"
-                                                                    : "write_operation_types"];
-    return obj.types[obj.distribution(rnd::gen)];
+  OperationKind const & TraceGeneratorWorkload::GetRandomWriteOperationType(bool is_txn_op) {
+    return is_txn_op ? config.write_txn_operation_types(rnd::gen) : config.write_operation_types(rnd::gen);
   }
 
   Edge const & TraceGeneratorWorkload::GetRandomEdge() {
-    ConfigParser::LineObject & obj = config_parser.fields["primary_shards"];
-    auto it = shard_to_edges.find(obj.distribution(rnd::gen));
-    while (it == shard_to_edges.end()) {
-      it = shard_to_edges.find(obj.distribution(rnd::gen));
+    if (!edge_shards) {
+      throw std::runtime_error("No edges were loaded for any shard the workload reads from");
     }
-
-    std::uniform_int_distribution<int> edge_selector(0, (it->second).size()-1);
-    return (it->second)[edge_selector(rnd::gen)];
+    std::vector<Edge> const & edges = shard_to_edges[(*edge_shards)(rnd::gen)];
+    std::uniform_int_distribution<int> edge_selector(0, edges.size()-1);
+    return edges[edge_selector(rnd::gen)];
   }
   
-  std::string TraceGeneratorWorkload::GetValue() {
-    std::vector<unsigned char> random_chars(constants::VALUE_SIZE_BYTES);
-    std::generate(random_chars.begin(), random_chars.end(), std::ref(rnd::byte_engine));
-    for (size_t i = 0; i < constants::VALUE_SIZE_BYTES; ++i) {
-      random_chars[i] = 'a' + (random_chars[i] % 26);
+  std::string_view TraceGeneratorWorkload::GetValue(size_t size) {
+    // client threads outlive workloads, so an arena is only replaced when its
+    // size changes
+    thread_local std::unique_ptr<ValueArena> arena;
+    if (!arena || arena->size() != value_arena_bytes) {
+      arena = std::make_unique<ValueArena>(value_arena_bytes, rnd::gen);
     }
-    return {random_chars.begin(), random_chars.end()};
+    return arena->Get(size, rnd::gen);
+  }
+
+  std::string_view TraceGeneratorWorkload::GetValue(DataTable table) {
+    WeightedValues<int> const & sizes = table == DataTable::Edges ? config.edge_value_sizes
+                                                                  : config.object_value_sizes;
+    return GetValue(sizes(rnd::gen));
   }
 
   DB::DB_Operation TraceGeneratorWorkload::GetReadOperation(bool is_txn_op) {
-    std::string operation_type = GetRandomReadOperationType(is_txn_op);
-    bool is_edge_op = operation_type.find("edge") != std::string::npos;
+    OperationKind const & operation_kind = GetRandomReadOperationType(is_txn_op);
     Edge const & edge = GetRandomEdge();
-    if (is_edge_op) {
+    if (operation_kind.table == DataTable::Edges) {
       return {DataTable::Edges,
-               {{"id1", edge.primary_key}, {"id2", edge.remote_key},
-                  {"type", static_cast<int64_t>(edge.type)}},
-               {0L, ""},
+               {edge.primary_key, edge.remote_key, static_cast<int64_t>(edge.type)},
+               {0L, {}},
                Operation::READ
              };
     } else {
       return {DataTable::Objects,
-               {{"id", edge.primary_key}},
-               {0L, ""},
+               {edge.primary_key, 0, 0},
+               {0L, {}},
                Operation::READ
              };
     }
   }
 
   DB::DB_Operation TraceGeneratorWorkload::GetWriteOperation(bool is_txn_op) {
-    std::string operation_type = GetRandomWriteOperationType(is_txn_op);
-    bool is_edge_op = operation_type.find("edge") != std::string::npos;
-    Operation db_op_type;
-    // TODO - make these actual values?
-    if (operation_type.find("add") != std::string::npos) {
-      db_op_type = Operation::INSERT;
-    } else if (operation_type == "obj_update" || operation_type == "edge_update") {
-      db_op_type = Operation::UPDATE;
-    } else if (operation_type == "obj_delete" || operation_type == "edge_delete") {
-      db_op_type = Operation::DELETE;
-    } else {
-      throw std::invalid_argument("Unrecognized write operation");
-    }
+    OperationKind const & operation_kind = GetRandomWriteOperationType(is_txn_op);
+    Operation db_op_type = operation_kind.op;
 
     Edge edge;
     if (db_op_type != Operation::INSERT) {
       edge = GetRandomEdge();
     } else {
-      ConfigParser::LineObject & primary_shards = config_parser.fields["primary_shards"];
-      ConfigParser::LineObject & remote_shards = config_parser.fields["remote_shards"];
-      edge.primary_key = GenerateKey(primary_shards.distribution(rnd::gen));
-      edge.remote_key = GenerateKey(remote_shards.distribution(rnd::gen));
+      edge.primary_key = GenerateKey(config.primary_shards(rnd::gen));
+      edge.remote_key = GenerateKey(config.remote_shards(rnd::gen));
       edge.type = GetRandomEdgeType();
     }
     int64_t timestamp = utils::CurrentTimeNanos();
-    std::string value = GetValue();
-    if (is_edge_op) {
+    std::string_view value = GetValue(operation_kind.table);
+    if (operation_kind.table == DataTable::Edges) {
       return {DataTable::Edges,
-               {{"id1", edge.primary_key}, {"id2", edge.remote_key}, {"type", static_cast<int64_t>(edge.type)}},
-               {timestamp, std::move(value)},
+               {edge.primary_key, edge.remote_key, static_cast<int64_t>(edge.type)},
+               {timestamp, value},
                db_op_type
              };
     } else {
       return {DataTable::Objects,
-               {{"id", edge.primary_key}},
-               {timestamp, std::move(value)},
+               {edge.primary_key, 0, 0},
+               {timestamp, value},
                db_op_type
              };
     }
   }
 
-  std::vector<DB::DB_Operation> TraceGeneratorWorkload::GetReadTransaction() {
-    ConfigParser::LineObject & obj = config_parser.fields["read_txn_sizes"];
-    int transaction_size = obj.vals[obj.distribution(rnd::gen)];
-    std::vector<DB::DB_Operation> ops;
+  void TraceGeneratorWorkload::GetReadTransaction(std::vector<DB::DB_Operation> & ops) {
+    int transaction_size = config.read_txn_sizes(rnd::gen);
     for (int i = 0; i < transaction_size; ++i) {
       ops.push_back(GetReadOperation(true));
     }
-    return ops;
   }
 
-  std::vector<DB::DB_Operation> TraceGeneratorWorkload::GetWriteTransaction() {
-    ConfigParser::LineObject & obj = config_parser.fields["write_txn_sizes"];
-    int transaction_size = obj.vals[obj.distribution(rnd::gen)];
-    std::vector<DB::DB_Operation> ops;
+  void TraceGeneratorWorkload::GetWriteTransaction(std::vector<DB::DB_Operation> & ops) {
+    int transaction_size = config.write_txn_sizes(rnd::gen);
     for (int i = 0; i < transaction_size; ++i) {
       ops.push_back(GetWriteOperation(true));
     }
-    return ops;
   }
 }
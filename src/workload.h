@@ -1,25 +1,26 @@
 #ifndef WORKLOAD_H_
 #define WORKLOAD_H_
 
+#include <optional>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <ctime>
 #include <climits>
 #include <thread>
 #include "db.h"
+#include "measurements.h"
 #include "timer.h"
 #include "properties.h"
 #include "utils.h"
-#include "parse_config.h"
+#include "workload_config.h"
 #include "workload_loader.h"
 #include "edge.h"
 
 namespace benchmark {
 namespace rnd {
   thread_local static std::mt19937 gen(std::random_device{}());
-  thread_local static std::independent_bits_engine<std::default_random_engine,
-        CHAR_BIT, unsigned char> byte_engine;
 }
 
 namespace counter {
@@ -45,8 +46,10 @@ public:
   TraceGeneratorWorkload(const utils::Properties &p);
 
   // This constructor is used in the run phase; we combine the workload keypools loaded by each loader.
+  // Request outcomes and retries are reported to measurements, if given.
   TraceGeneratorWorkload(const utils::Properties &p,
-                         std::vector<std::shared_ptr<WorkloadLoader>> const & loaders);
+                         std::vector<std::shared_ptr<WorkloadLoader>> const & loaders,
+                         Measurements *measurements = nullptr);
 
   void Init(DB &db) override;
 
@@ -75,34 +78,49 @@ public:
 
 private:
 
-  Status DispatchRequest(DB &db);
+  // Runs request until it does not hit contention, backing off exponentially
+  // between attempts, and reports the outcome of the request as op.
+  template <typename Request>
+  bool ExecuteWithRetries(Operation op, Request const & request);
 
   int64_t GenerateKey(int shard);
 
-  void ResizeShardWeights(int num_shards);
-
   EdgeType GetRandomEdgeType();
 
-  std::string GetRandomReadOperationType(bool is_txn_op);
+  OperationKind const & GetRandomReadOperationType(bool is_txn_op);
 
-  std::string GetRandomWriteOperationType(bool is_txn_op);
+  OperationKind const & GetRandomWriteOperationType(bool is_txn_op);
 
   Edge const & GetRandomEdge();
 
-  std::string GetValue();
+  // Random value of @param size bytes from the calling thread's value arena;
+  // valid until the thread sees a workload with a different
+  // value.arena_bytes.
+  std::string_view GetValue(size_t size);
+
+  // Random value with a size drawn from the config's value sizes of
+  // @param table.
+  std::string_view GetValue(DataTable table);
 
   DB::DB_Operation GetReadOperation(bool is_txn_op);
 
   DB::DB_Operation GetWriteOperation(bool is_txn_op);
 
-  std::vector<DB::DB_Operation> GetReadTransaction();
+  // Append the operations of a new transaction to @param ops.
+  void GetReadTransaction(std::vector<DB::DB_Operation> & ops);
 
-  std::vector<DB::DB_Operation> GetWriteTransaction();
+  void GetWriteTransaction(std::vector<DB::DB_Operation> & ops);
 
-  ConfigParser config_parser;
+  WorkloadConfig const config;
   std::string const object_table;
   std::string const edge_table;
-  std::unordered_map<int, std::vector<Edge>> const shard_to_edges;
+  std::vector<std::vector<Edge>> const shard_to_edges; // indexed by primary shard
+  // primary_shards restricted to the shards that have edges; unset if none do
+  std::optional<AliasSampler> const edge_shards;
+  Measurements * const measurements;
+  // -1 retries contended requests until they succeed
+  int const max_contention_retries;
+  size_t const value_arena_bytes;
 };
 
 } // benchmark
@@ -0,0 +1,133 @@
+#include "workload_config.h"
+#include "constants.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace benchmark {
+
+namespace {
+  ConfigParser::LineObject const &Line(ConfigParser const &parser, std::string const &name) {
+    auto it = parser.fields.find(name);
+    if (it == parser.fields.end()) {
+      throw std::invalid_argument("Workload config has no " + name + " line");
+    }
+    return it->second;
+  }
+
+  // Only the first num_shards shards exist; if the config has weights for
+  // more, consecutive weights are summed up so that the shape of the
+  // distribution is kept.
+  std::vector<double> FoldShardWeights(std::vector<double> const &weights, int num_shards) {
+    if (weights.size() <= static_cast<size_t>(num_shards)) {
+      return weights;
+    }
+    std::vector<double> folded(num_shards);
+    double interval = (1.0 * weights.size()) / num_shards;
+    for (size_t oldi = 0, newi = 0; newi < folded.size(); ++newi) {
+      while (oldi < weights.size() && (double) oldi < interval * (newi+1)) {
+        folded[newi] += weights[oldi++];
+      }
+    }
+    return folded;
+  }
+
+  WeightedValues<RequestKind> RequestKinds(ConfigParser const &parser) {
+    ConfigParser::LineObject const &line = Line(parser, "operations");
+    if (line.weights.size() > kNumRequestKinds) {
+      throw std::invalid_argument("Workload config line operations has more than "
+                                  + std::to_string(kNumRequestKinds) + " weights");
+    }
+    std::vector<RequestKind> kinds;
+    for (size_t i = 0; i < line.weights.size(); ++i) {
+      kinds.push_back(static_cast<RequestKind>(i));
+    }
+    return {line.name, kinds, line.weights};
+  }
+
+  WeightedValues<EdgeType> EdgeTypes(ConfigParser const &parser) {
+    ConfigParser::LineObject const &line = Line(parser, "edge_types");
+    std::vector<EdgeType> types;
+    for (std::string const &type : line.types) {
+      types.push_back(EdgeStringToType(type));
+    }
+    return {line.name, types, line.weights};
+  }
+
+  // Types naming an edge operation, e.g. "edge_add", go to the edges table,
+  // all others to the objects table.
+  WeightedValues<OperationKind> OperationKinds(ConfigParser const &parser, std::string const &name,
+                                               bool write) {
+    ConfigParser::LineObject const &line = Line(parser, name);
+    std::vector<OperationKind> kinds;
+    for (std::string const &type : line.types) {
+      OperationKind kind {type.find("edge") != std::string::npos ? DataTable::Edges : DataTable::Objects,
+                          Operation::READ};
+      if (!write) {
+        // any read type is a point read
+      } else if (type.find("add") != std::string::npos) {
+        kind.op = Operation::INSERT;
+      } else if (type == "obj_update" || type == "edge_update") {
+        kind.op = Operation::UPDATE;
+      } else if (type == "obj_delete" || type == "edge_delete") {
+        kind.op = Operation::DELETE;
+      } else {
+        throw std::invalid_argument("Unrecognized write operation " + type + " in " + name);
+      }
+      kinds.push_back(kind);
+    }
+    return {line.name, kinds, line.weights};
+  }
+
+  WeightedValues<int> Sizes(ConfigParser const &parser, std::string const &name) {
+    ConfigParser::LineObject const &line = Line(parser, name);
+    return {line.name, line.vals, line.weights};
+  }
+
+  // Optional, as configs from before value sizes could be configured have
+  // every value at the same size.
+  WeightedValues<int> ValueSizes(ConfigParser const &parser, std::string const &name) {
+    if (parser.fields.find(name) == parser.fields.end()) {
+      return {name, {constants::VALUE_SIZE_BYTES}, {1}};
+    }
+    WeightedValues<int> sizes = Sizes(parser, name);
+    if (sizes.values().empty()) {
+      throw std::invalid_argument("Workload config line " + name + " has no sizes");
+    }
+    for (int size : sizes.values()) {
+      if (size < 0) {
+        throw std::invalid_argument("Workload config line " + name + " has a negative size");
+      }
+    }
+    return sizes;
+  }
+}
+
+WorkloadConfig::WorkloadConfig(std::string const &path, int num_shards)
+    : WorkloadConfig(ConfigParser(path), num_shards)
+{
+}
+
+WorkloadConfig::WorkloadConfig(ConfigParser const &parser, int num_shards)
+    : operations(RequestKinds(parser))
+    , primary_shard_weights(FoldShardWeights(Line(parser, "primary_shards").weights, num_shards))
+    , primary_shards(primary_shard_weights)
+    , remote_shards(FoldShardWeights(Line(parser, "remote_shards").weights, num_shards))
+    , edge_types(EdgeTypes(parser))
+    , read_operation_types(OperationKinds(parser, "read_operation_types", false))
+    , read_txn_operation_types(OperationKinds(parser, "read_txn_operation_types", false))
+    , write_operation_types(OperationKinds(parser, "write_operation_types", true))
+    , write_txn_operation_types(OperationKinds(parser, "write_txn_operation_types", true))
+    , read_txn_sizes(Sizes(parser, "read_txn_sizes"))
+    , write_txn_sizes(Sizes(parser, "write_txn_sizes"))
+    , object_value_sizes(ValueSizes(parser, "object_value_sizes"))
+    , edge_value_sizes(ValueSizes(parser, "edge_value_sizes"))
+{
+}
+
+int WorkloadConfig::MaxValueSize() const {
+  return std::max(*std::max_element(object_value_sizes.values().begin(), object_value_sizes.values().end()),
+                  *std::max_element(edge_value_sizes.values().begin(), edge_value_sizes.values().end()));
+}
+
+} // benchmark
@@ -0,0 +1,96 @@
+#ifndef WORKLOAD_CONFIG_H_
+#define WORKLOAD_CONFIG_H_
+
+#include <string>
+#include <vector>
+
+#include "alias_sampler.h"
+#include "db.h"
+#include "edge.h"
+#include "parse_config.h"
+
+namespace benchmark {
+
+// Kinds of requests, in the order of the weights of the "operations" config
+// line.
+enum class RequestKind {
+  READ,
+  WRITE,
+  READ_TRANSACTION,
+  WRITE_TRANSACTION,
+  MAXREQUESTKIND
+};
+
+constexpr int kNumRequestKinds = static_cast<int>(RequestKind::MAXREQUESTKIND);
+
+// An operation type of the config, such as "edge_add" or "obj_update".
+struct OperationKind {
+  DataTable table;
+  Operation op; // READ, INSERT, UPDATE or DELETE
+};
+
+// The values of a config line, drawn with the line's weights.
+template <class T>
+class WeightedValues {
+ public:
+  // Throws std::invalid_argument unless there is one weight per value.
+  WeightedValues(std::string const &name, std::vector<T> values, std::vector<double> const &weights)
+      : values_(std::move(values))
+      , sampler_(weights)
+  {
+    if (values_.size() != weights.size()) {
+      throw std::invalid_argument("Workload config line " + name + " has " + std::to_string(values_.size())
+                                  + " values but " + std::to_string(weights.size()) + " weights");
+    }
+  }
+
+  template <class URNG>
+  T const &operator()(URNG &gen) const {
+    return values_[sampler_(gen)];
+  }
+
+  std::vector<T> const &values() const {
+    return values_;
+  }
+
+ private:
+  std::vector<T> values_;
+  AliasSampler sampler_;
+};
+
+///
+/// The workload config of a TraceGeneratorWorkload, with every line the
+/// request path samples from resolved once into a sampler over typed values.
+/// Generating a request then neither looks up config lines by name nor
+/// compares operation type strings.
+///
+struct WorkloadConfig {
+  // Reads the config at @param path, folding the shard weights into
+  // @param num_shards shards if there are more. Throws std::invalid_argument
+  // if a required line is missing or a line is malformed.
+  WorkloadConfig(std::string const &path, int num_shards);
+
+  WeightedValues<RequestKind> operations;
+  std::vector<double> primary_shard_weights; // indexed by shard
+  AliasSampler primary_shards;
+  AliasSampler remote_shards;
+  WeightedValues<EdgeType> edge_types;
+  WeightedValues<OperationKind> read_operation_types;
+  WeightedValues<OperationKind> read_txn_operation_types;
+  WeightedValues<OperationKind> write_operation_types;
+  WeightedValues<OperationKind> write_txn_operation_types;
+  WeightedValues<int> read_txn_sizes;
+  WeightedValues<int> write_txn_sizes;
+  // in bytes; constants::VALUE_SIZE_BYTES if the config has no such line
+  WeightedValues<int> object_value_sizes;
+  WeightedValues<int> edge_value_sizes;
+
+  int MaxValueSize() const;
+
+ private:
+  WorkloadConfig(ConfigParser const &parser, int num_shards);
+};
+
+} // benchmark
+
+#endif // WORKLOAD_CONFIG_H_
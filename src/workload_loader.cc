@@ -18,17 +18,19 @@ namespace benchmark {
                                      int64_t remote_key,
                                      EdgeType edge_type,
                                      int64_t timestamp,
-                                     std::string const & value,
+                                     std::string_view edge_value,
+                                     std::string_view primary_object_value,
+                                     std::string_view remote_object_value,
                                      int write_batch_size)
   {
     int failed_ops = 0;
     shard_to_edges[primary_shard].emplace_back(primary_key, remote_key, edge_type);
-    edge_value_buffer.emplace_back(timestamp, value);
+    edge_value_buffer.emplace_back(timestamp, std::string(edge_value));
     edge_key_buffer.push_back({{"id1", primary_key}, {"id2", remote_key}, {"type", static_cast<int64_t>(edge_type)}});
     object_key_buffer.push_back({{"id", primary_key}});
     object_key_buffer.push_back({{"id", remote_key}});
-    object_value_buffer.emplace_back(timestamp, value);
-    object_value_buffer.emplace_back(timestamp, value);
+    object_value_buffer.emplace_back(timestamp, std::string(primary_object_value));
+    object_value_buffer.emplace_back(timestamp, std::string(remote_object_value));
     if (edge_value_buffer.size() > write_batch_size) {
       failed_ops += FlushEdgeBuffer();
     }
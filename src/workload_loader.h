@@ -23,7 +23,9 @@ namespace benchmark {
                        int64_t remote_key,
                        EdgeType edge_type,
                        int64_t timestamp,
-                       std::string const & value,
+                       std::string_view edge_value,
+                       std::string_view primary_object_value,
+                       std::string_view remote_object_value,
                        int write_batch_size);
 
     bool FlushEdgeBuffer();
@@ -57,7 +57,18 @@ void YugabyteDB::Cleanup() {
   delete ysql_conn_;
 }
 
-Status YugabyteDB::Read(DataTable table, const std::vector<Field> &key, std::vector<TimestampValue> &result) {
+Status YugabyteDB::Ping() {
+    try {
+      pqxx::nontransaction tx(*ysql_conn_);
+      tx.exec("SELECT 1");
+      return Status::kOK;
+    } catch (std::exception const &e) {
+      std::cerr << e.what() << std::endl;
+      return Status::kError;
+    }
+}
+
+Status YugabyteDB::Read(DataTable table, const Key &key, std::vector<TimestampValue> &result) {
 
     //const std::lock_guard<std::mutex> lock(mu_);
     // Execute SQL commands
@@ -79,13 +90,13 @@ Status YugabyteDB::Read(DataTable table, const std::vector<Field> &key, std::vec
 }
 
 /* Helper function to execute the read prepare statement 
-   Objects: key[0] = id
-   Edges: key[0] = id1, key[1] = id2, key[2] = type */
-pqxx::result YugabyteDB::DoRead(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key) {
+   Objects: key.id1 = id
+   Edges: key.id1, key.id2, key.type */
+pqxx::result YugabyteDB::DoRead(pqxx::transaction_base &tx, DataTable table, const Key &key) {
   if (table == DataTable::Objects) {
-    return tx.exec_prepared("read_object", key[0].value);
+    return tx.exec_prepared("read_object", key.id1);
   } else if (table == DataTable::Edges) {
-    return tx.exec_prepared("read_edge", key[0].value, key[1].value, key[2].value);
+    return tx.exec_prepared("read_edge", key.id1, key.id2, key.type);
   } else {
     throw std::invalid_argument("Received unknown table");
   }
@@ -93,7 +104,7 @@ pqxx::result YugabyteDB::DoRead(pqxx::transaction_base &tx, DataTable table, con
 
 
 Status YugabyteDB::Scan(DataTable table,
-                    const std::vector<Field> &key,
+                    const Key &key,
                     int n,
                     std::vector<TimestampValue> &buffer) {
     // const std::lock_guard<std::mutex> lock(mu_);
@@ -127,7 +138,7 @@ Status YugabyteDB::Scan(DataTable table,
 /* Helper function to execute the scan prepare statement 
    start: the start of the yb_hash_code(id) to scan
    end: the end of the yb_hash_code(id) to scan */
-// pqxx::result YugabyteDB::DoScan(pqxx::transaction_base &tx, const std::string &table, const std::vector<Field> &key, int len,
+// pqxx::result YugabyteDB::DoScan(pqxx::transaction_base &tx, const std::string &table, const Key &key, int len,
 //                          const std::vector<std::string> *fields, int start, int end) {
 //   if (table == "objects") {
 //     return tx.exec_prepared("scan_object", start, end, len);
@@ -138,7 +149,7 @@ Status YugabyteDB::Scan(DataTable table,
 //   }
 // }
 
-Status YugabyteDB::Update(DataTable table, const std::vector<DB::Field> &key, TimestampValue const &value) {
+Status YugabyteDB::Update(DataTable table, const Key &key, TimestampValueRef const &value) {
     
     //const std::lock_guard<std::mutex> lock(mu_);
     try
@@ -155,20 +166,20 @@ Status YugabyteDB::Update(DataTable table, const std::vector<DB::Field> &key, Ti
 }
 
 /* Helper function to execute the update prepare statement 
-   Objects: key[0] = id
-   Edges: key[0] = id1, key[1] = id2, key[2] = type */
-pqxx::result YugabyteDB::DoUpdate(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key, TimestampValue const &timeval) {
+   Objects: key.id1 = id
+   Edges: key.id1, key.id2, key.type */
+pqxx::result YugabyteDB::DoUpdate(pqxx::transaction_base &tx, DataTable table, const Key &key, TimestampValueRef const &timeval) {
   if (table == DataTable::Objects) {
-    return tx.exec_prepared("update_object", timeval.timestamp, timeval.value, key[0].value);
+    return tx.exec_prepared("update_object", timeval.timestamp, timeval.value, key.id1);
   } else if (table == DataTable::Edges) {
-    return tx.exec_prepared("update_edge", timeval.timestamp, timeval.value, key[0].value, key[1].value, key[2].value);
+    return tx.exec_prepared("update_edge", timeval.timestamp, timeval.value, key.id1, key.id2, key.type);
   } else {
     throw std::invalid_argument("Received unknown table");
   }
 }
 
 
-Status YugabyteDB::Insert(DataTable table, const std::vector<Field> &key, const TimestampValue & timeval) {
+Status YugabyteDB::Insert(DataTable table, const Key &key, const TimestampValueRef & timeval) {
     assert(!key.empty());
     //const std::lock_guard<std::mutex> lock(mu_);
     try
@@ -185,21 +196,21 @@ Status YugabyteDB::Insert(DataTable table, const std::vector<Field> &key, const
 }
 
 /* Helper function to execute the insert prepare statement 
-   Objects: key[0] = id
-   Edges: key[0] = id1, key[1] = id2, key[2] = type */
-pqxx::result YugabyteDB::DoInsert(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key, const TimestampValue & timeval) {
+   Objects: key.id1 = id
+   Edges: key.id1, key.id2, key.type */
+pqxx::result YugabyteDB::DoInsert(pqxx::transaction_base &tx, DataTable table, const Key &key, const TimestampValueRef & timeval) {
   if (table == DataTable::Objects) {
-    return tx.exec_prepared("insert_object", key[0].value, timeval.timestamp, timeval.value);
+    return tx.exec_prepared("insert_object", key.id1, timeval.timestamp, timeval.value);
   } else if (table == DataTable::Edges) {
-    benchmark::EdgeType type = static_cast<benchmark::EdgeType>(key[2].value);
+    benchmark::EdgeType type = static_cast<benchmark::EdgeType>(key.type);
     if (type == benchmark::EdgeType::Other) {
-      return tx.exec_prepared("insert_edge_other", key[0].value, key[1].value, key[2].value, timeval.timestamp, timeval.value);
+      return tx.exec_prepared("insert_edge_other", key.id1, key.id2, key.type, timeval.timestamp, timeval.value);
     } else if (type == benchmark::EdgeType::Bidirectional) {
-      return tx.exec_prepared("insert_edge_bidirectional", key[0].value, key[1].value, key[2].value, timeval.timestamp, timeval.value);
+      return tx.exec_prepared("insert_edge_bidirectional", key.id1, key.id2, key.type, timeval.timestamp, timeval.value);
     } else if (type == benchmark::EdgeType::Unique) {
-      return tx.exec_prepared("insert_edge_unique", key[0].value, key[1].value, key[2].value, timeval.timestamp, timeval.value);
+      return tx.exec_prepared("insert_edge_unique", key.id1, key.id2, key.type, timeval.timestamp, timeval.value);
     } else if (type == benchmark::EdgeType::UniqueAndBidirectional) {
-      return tx.exec_prepared("insert_edge_bi_unique", key[0].value, key[1].value, key[2].value, timeval.timestamp, timeval.value);
+      return tx.exec_prepared("insert_edge_bi_unique", key.id1, key.id2, key.type, timeval.timestamp, timeval.value);
     } else {
       throw std::invalid_argument("Received unknown type");
     }
@@ -321,7 +332,7 @@ Status YugabyteDB::BatchRead(DataTable table,
   }
 }   
 
-Status YugabyteDB::Delete(DataTable table, const std::vector<Field> &key, const TimestampValue & timeval) {
+Status YugabyteDB::Delete(DataTable table, const Key &key, const TimestampValueRef & timeval) {
 
     //const std::lock_guard<std::mutex> lock(mu_);
     try
@@ -338,13 +349,13 @@ Status YugabyteDB::Delete(DataTable table, const std::vector<Field> &key, const
 
 
 /* Helper function to execute the delete prepare statement 
-   Objects: key[0] = id
-   Edges: key[0] = id1, key[1] = id2, key[2] = type */
-pqxx::result YugabyteDB::DoDelete(pqxx::transaction_base &tx, DataTable table, const std::vector<Field> &key, const TimestampValue & timeval) {
+   Objects: key.id1 = id
+   Edges: key.id1, key.id2, key.type */
+pqxx::result YugabyteDB::DoDelete(pqxx::transaction_base &tx, DataTable table, const Key &key, const TimestampValueRef & timeval) {
   if (table == DataTable::Objects) {
-    return tx.exec_prepared("delete_object", key[0].value, timeval.timestamp);
+    return tx.exec_prepared("delete_object", key.id1, timeval.timestamp);
   } else if (table == DataTable::Edges) {
-    return tx.exec_prepared("delete_edge", key[0].value, key[1].value, key[2].value, timeval.timestamp);
+    return tx.exec_prepared("delete_edge", key.id1, key.id2, key.type, timeval.timestamp);
   } else {
     throw std::invalid_argument("Received unknown table");
   }
@@ -574,9 +585,9 @@ std::string YugabyteDB::ReadBatchQuery(const std::vector<DB_Operation> &read_ops
   for (int i = 0; i < read_ops.size(); i++) {
     const DB_Operation operation = read_ops[i];
     if (operation.table == DataTable::Objects) {
-      query += "SELECT timestamp, value FROM " + object_table_ + " WHERE id = " + std::to_string((operation.key)[0].value) + ";";
+      query += "SELECT timestamp, value FROM " + object_table_ + " WHERE id = " + std::to_string(operation.key.id1) + ";";
     } else if (operation.table == DataTable::Edges) {
-      query += "SELECT timestamp, value FROM " + edge_table_ + " WHERE id1 = " + std::to_string((operation.key)[0].value) + " AND id2 = " + std::to_string((operation.key)[1].value) + " AND type = " + std::to_string((operation.key)[2].value) + ";";
+      query += "SELECT timestamp, value FROM " + edge_table_ + " WHERE id1 = " + std::to_string(operation.key.id1) + " AND id2 = " + std::to_string(operation.key.id2) + " AND type = " + std::to_string(operation.key.type) + ";";
     }
   }
 
@@ -595,14 +606,14 @@ std::string YugabyteDB::InsertBatchQuery(const std::vector<DB_Operation> &insert
    for (size_t i = 0; i < insert_ops.size(); i++) {
     const DB_Operation operation = insert_ops[i];
     if (operation.table == DataTable::Objects) {
-      query += "INSERT INTO " +object_table_ + " (id, timestamp, value) VALUES (" + std::to_string((operation.key)[0].value) + ", " + std::to_string(operation.time_and_value.timestamp) + ", " + ysql_conn_->quote(operation.time_and_value.value) + ");";
+      query += "INSERT INTO " +object_table_ + " (id, timestamp, value) VALUES (" + std::to_string(operation.key.id1) + ", " + std::to_string(operation.time_and_value.timestamp) + ", " + ysql_conn_->quote(operation.time_and_value.value) + ");";
     } else if (operation.table == DataTable::Edges) {
-      std::string id1 = std::to_string((operation.key)[0].value);
-      std::string id2 = std::to_string((operation.key)[1].value);
-      std::string type = std::to_string((operation.key)[2].value);
+      std::string id1 = std::to_string(operation.key.id1);
+      std::string id2 = std::to_string(operation.key.id2);
+      std::string type = std::to_string(operation.key.type);
       std::string timestamp = std::to_string(operation.time_and_value.timestamp);
       std::string value = ysql_conn_->quote(operation.time_and_value.value);
-      benchmark::EdgeType edge_type = static_cast<benchmark::EdgeType>((operation.key)[2].value);
+      benchmark::EdgeType edge_type = static_cast<benchmark::EdgeType>(operation.key.type);
       query += "INSERT INTO " + edge_table_ + " (id1, id2, type, timestamp, value) SELECT " + id1 + ", " + id2 + ", " + type + ", " + timestamp + ", " + value + " WHERE NOT EXISTS ";
       if (edge_type == benchmark::EdgeType::Other) {
         query +=  "(SELECT 1 FROM " + edge_table_ + " WHERE (id1=" + id1 + " AND type=0) OR (id1=" + id1 + " AND type=2) OR (id1=" + id1 + " AND id2=" + id2 + " AND type=1) OR (id1=" + id2 + " AND id2=" + id1 + "));";
@@ -624,9 +635,9 @@ std::string YugabyteDB::UpdateBatchQuery(const std::vector<DB_Operation> &update
    for (int i = 0; i < update_ops.size(); i++) {
     const DB_Operation operation = update_ops[i];
     if (operation.table == DataTable::Objects) {
-      query += "UPDATE " +object_table_ + " SET timestamp = " + std::to_string(operation.time_and_value.timestamp) + ", value = " + ysql_conn_->quote(operation.time_and_value.value) + " WHERE id = " + std::to_string((operation.key)[0].value) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp) + ";";
+      query += "UPDATE " +object_table_ + " SET timestamp = " + std::to_string(operation.time_and_value.timestamp) + ", value = " + ysql_conn_->quote(operation.time_and_value.value) + " WHERE id = " + std::to_string(operation.key.id1) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp) + ";";
     } else if (operation.table == DataTable::Edges) {
-      query += "UPDATE " + edge_table_ + " SET timestamp = " + std::to_string(operation.time_and_value.timestamp) + ", value = " + ysql_conn_->quote(operation.time_and_value.value) + " WHERE id1 = " + std::to_string((operation.key)[0].value) + " AND id2 = " + std::to_string((operation.key)[1].value) + " AND type = " + std::to_string((operation.key)[2].value) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp) + ";";
+      query += "UPDATE " + edge_table_ + " SET timestamp = " + std::to_string(operation.time_and_value.timestamp) + ", value = " + ysql_conn_->quote(operation.time_and_value.value) + " WHERE id1 = " + std::to_string(operation.key.id1) + " AND id2 = " + std::to_string(operation.key.id2) + " AND type = " + std::to_string(operation.key.type) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp) + ";";
     }
   }
   return query;
@@ -638,9 +649,9 @@ std::string YugabyteDB::DeleteBatchQuery(const std::vector<DB_Operation> &delete
    for (int i = 0; i < delete_ops.size(); i++) {
     const DB_Operation operation = delete_ops[i];
     if (operation.table == DataTable::Objects) {
-      query += "DELETE FROM " +object_table_ + " WHERE id = " + std::to_string((operation.key)[0].value) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp) + ";";
+      query += "DELETE FROM " +object_table_ + " WHERE id = " + std::to_string(operation.key.id1) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp) + ";";
     } else if (operation.table == DataTable::Edges) {
-      query += "DELETE FROM " + edge_table_ + " WHERE id1 = " + std::to_string((operation.key)[0].value) + " AND id2 = " + std::to_string((operation.key)[1].value) + " AND type = " + std::to_string((operation.key)[2].value) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp) + ";";
+      query += "DELETE FROM " + edge_table_ + " WHERE id1 = " + std::to_string(operation.key.id1) + " AND id2 = " + std::to_string(operation.key.id2) + " AND type = " + std::to_string(operation.key.type) + " AND timestamp < " + std::to_string(operation.time_and_value.timestamp) + ";";
     }
   }
   return query;
@@ -18,20 +18,22 @@ public:
 
   void Cleanup();
 
-  Status Read(DataTable table, const std::vector<DB::Field> &key,
+  Status Ping();
+
+  Status Read(DataTable table, const Key &key,
               std::vector<TimestampValue> &buffer);
 
-  Status Scan(DataTable table, const std::vector<DB::Field> &key, int n,
+  Status Scan(DataTable table, const Key &key, int n,
               std::vector<TimestampValue> &buffer);
 
-  Status Update(DataTable table, const std::vector<DB::Field> &key,
-                TimestampValue const &value);
+  Status Update(DataTable table, const Key &key,
+                TimestampValueRef const &value);
 
-  Status Insert(DataTable table, const std::vector<DB::Field> &key,
-                TimestampValue const &value);
+  Status Insert(DataTable table, const Key &key,
+                TimestampValueRef const &value);
 
-  Status Delete(DataTable table, const std::vector<DB::Field> &key,
-                TimestampValue const &value);
+  Status Delete(DataTable table, const Key &key,
+                TimestampValueRef const &value);
 
   Status Execute(const DB_Operation &operation,
                  std::vector<TimestampValue> &read_buffer, bool txn_op = false);
@@ -56,19 +58,19 @@ private:
 
   /* Helper functions to execute the prepared statements done in Init */
   pqxx::result DoRead(pqxx::transaction_base &tx, DataTable table,
-                      const std::vector<Field> &key);
+                      const Key &key);
 
   pqxx::result DoUpdate(pqxx::transaction_base &tx, DataTable table,
-                        const std::vector<Field> &key,
-                        TimestampValue const &value);
+                        const Key &key,
+                        TimestampValueRef const &value);
 
   pqxx::result DoInsert(pqxx::transaction_base &tx, DataTable table,
-                        const std::vector<Field> &key,
-                        const TimestampValue &timeval);
+                        const Key &key,
+                        const TimestampValueRef &timeval);
 
   pqxx::result DoDelete(pqxx::transaction_base &tx, DataTable table,
-                        const std::vector<Field> &key,
-                        const TimestampValue &timeval);
+                        const Key &key,
+                        const TimestampValueRef &timeval);
 
   Status BatchInsertObjects(DataTable table,
                             const std::vector<std::vector<Field>> &keys,